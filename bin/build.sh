@@ -63,7 +63,7 @@ done
 # Common flags (matching code_base build)
 COMMON_FLAGS="-Wall -Wextra"
 COMMON_FLAGS="$COMMON_FLAGS -Wno-unused-function -Wno-unused-variable -Wno-unused-parameter"
-COMMON_FLAGS="$COMMON_FLAGS -Wno-missing-braces -Wno-missing-field-initializers"
+COMMON_FLAGS="$COMMON_FLAGS -Wno-missing-braces -Wno-missing-field-initializers -Wno-override-init"
 COMMON_FLAGS="$COMMON_FLAGS -Wno-unused-value -Wno-enum-conversion -Wno-enum-enum-conversion"
 COMMON_FLAGS="$COMMON_FLAGS -fno-strict-aliasing"
 
@@ -9,18 +9,40 @@ arena_alloc_(Arena_Params *params) {
     ArenaFlags flags = params->flags;
     b32        growing = !(flags & ArenaFlag_NoChain);
 
+    // Whole large pages only, or the tail of the chunk falls back to 4KB.
+    if ((flags & ArenaFlag_LargePages) && !params->backing_buffer) {
+        reserve_size = AlignUpPow2(reserve_size, MB(2));
+    }
+
     if (reserve_size >= MEM_INITIAL_COMMIT) {
-        void *mem = 0;
+        void              *mem = 0;
+        OS_Large_Page_Mode large_page_mode = OS_Large_Page_Mode_None;
 
         if (params->backing_buffer) {
             mem = params->backing_buffer;
         } else if (flags & ArenaFlag_LargePages) {
-            mem = os_reserve_large(reserve_size);
+            mem = os_reserve_large(reserve_size, &large_page_mode);
         } else {
             mem = os_reserve(reserve_size);
         }
 
-        if (mem && (params->backing_buffer || os_commit(mem, MEM_INITIAL_COMMIT))) {
+        // The policy has to be set before any page is touched, and the
+        // header page below is committed (and touched) right away.
+        if (mem && !params->backing_buffer) {
+            if (flags & ArenaFlag_NumaBind) {
+                os_numa_bind(mem, reserve_size, params->numa_node);
+            } else if (flags & ArenaFlag_NumaInterleave) {
+                os_numa_interleave(mem, reserve_size);
+            }
+        }
+
+        // Explicit huge pages come back committed, and committing 4KB of one
+        // would fail, so treat the whole chunk like a backing buffer. The
+        // commit policies in flags skip this chunk but still apply to the
+        // ones chained after it, which can be ordinary pages.
+        b32 precommitted = params->backing_buffer || large_page_mode == OS_Large_Page_Mode_Explicit;
+
+        if (mem && (precommitted || os_commit(mem, MEM_INITIAL_COMMIT))) {
             res = (Arena *)mem;
             res->current = res;
             res->prev = 0;
@@ -29,10 +51,14 @@ arena_alloc_(Arena_Params *params) {
             res->default_reserve_size = reserve_size;
             res->default_commit_size = commit_size;
             res->growing = (b8)growing;
+            res->numa_node = params->numa_node;
+            res->large_page_mode = large_page_mode;
+            res->precommitted = (b8)precommitted;
             res->base_pos = 0;
             res->chunk_cap = reserve_size;
             res->chunk_pos = MEM_INTERNAL_MIN_SIZE;
-            res->chunk_commit_pos = params->backing_buffer ? reserve_size : MEM_INITIAL_COMMIT;
+            res->chunk_commit_pos = precommitted ? reserve_size : MEM_INITIAL_COMMIT;
+            res->commit_ahead = 0;
 
 #if ARENA_FREE_LIST
             res->free_last = 0;
@@ -43,7 +69,7 @@ arena_alloc_(Arena_Params *params) {
             res->allocation_site_line = params->allocation_site_line;
 #endif
 
-            if (!params->backing_buffer && res->chunk_commit_pos < res->chunk_cap) {
+            if (!precommitted && res->chunk_commit_pos < res->chunk_cap) {
                 void *poison_start = (u8 *)res + res->chunk_commit_pos;
                 u64   poison_size = res->chunk_cap - res->chunk_commit_pos;
                 AsanPoisonMemoryRegion(poison_start, poison_size);
@@ -61,6 +87,59 @@ arena_alloc_(Arena_Params *params) {
     return res;
 }
 
+// Commits the current chunk up to at least new_pos, in default_commit_size
+// steps. With ArenaFlag_CommitAhead each commit also takes commit_ahead
+// extra bytes and doubles it, so a steadily growing arena makes
+// logarithmically many commit calls instead of one per step.
+static b32
+arena_commit_to(Arena *arena, Arena *current, u64 new_pos) {
+    if (current->precommitted) {
+        return new_pos <= current->chunk_commit_pos;
+    }
+    u64 step = arena->default_commit_size;
+    u64 target = ((new_pos + step - 1) / step) * step;
+    if (arena->flags & ArenaFlag_CommitAhead) {
+        target = Max(target, current->chunk_commit_pos + arena->commit_ahead);
+        arena->commit_ahead = Min(Max(2 * arena->commit_ahead, step), MEM_COMMIT_AHEAD_MAX);
+    }
+    u64 new_commit_pos = Min(target, current->chunk_cap);
+    u64 commit_size = new_commit_pos - current->chunk_commit_pos;
+
+    void *commit_ptr = (u8 *)current + current->chunk_commit_pos;
+    if (!os_commit(commit_ptr, commit_size)) {
+        log_error("[arena] Failed to commit %llu bytes at %p (errno=%d)\n", commit_size, commit_ptr, errno);
+        return 0;
+    }
+    if (arena->flags & ArenaFlag_Prefault) {
+        os_prefault(commit_ptr, commit_size);
+    }
+    AsanUnpoisonMemoryRegion(commit_ptr, commit_size);
+    current->chunk_commit_pos = new_commit_pos;
+    return 1;
+}
+
+// ArenaFlag_Decommit: once more than two steps sit committed above the
+// chunk's position, give back everything but one step. The one-step band
+// keeps a push/pop loop around a boundary from committing and decommitting
+// on every iteration.
+static void
+arena_decommit_excess(Arena *arena, Arena *chunk) {
+    if (chunk->precommitted) {
+        return;
+    }
+    u64 step = arena->default_commit_size;
+    u64 keep = Max(AlignUpPow2(chunk->chunk_pos, KB(4)) + step, MEM_INITIAL_COMMIT);
+    if (chunk->chunk_commit_pos > keep + step) {
+        void *decommit_ptr = (u8 *)chunk + keep;
+        u64   decommit_size = chunk->chunk_commit_pos - keep;
+        AsanUnpoisonMemoryRegion(decommit_ptr, decommit_size);
+        os_decommit(decommit_ptr, decommit_size);
+        AsanPoisonMemoryRegion(decommit_ptr, decommit_size);
+        chunk->chunk_commit_pos = keep;
+        arena->commit_ahead /= 2;
+    }
+}
+
 static Arena *
 arena_new(u64 reserve_size, u64 alignment, b32 growing) {
     Arena_Params params = {0};
@@ -143,6 +222,7 @@ arena_push(Arena *arena, u64 size) {
             chunk_params.reserve_size = new_chunk_size;
             chunk_params.commit_size = arena->default_commit_size;
             chunk_params.alignment = align;
+            chunk_params.numa_node = arena->numa_node;
 
             new_chunk = arena_alloc_(&chunk_params);
             if (!new_chunk)
@@ -159,19 +239,8 @@ arena_push(Arena *arena, u64 size) {
         new_pos = pos_mem_aligned + size;
     }
 
-    if (new_pos > current->chunk_commit_pos) {
-        u64 commit_size_aligned = AlignUpPow2(new_pos, MEM_COMMIT_BLOCK_SIZE);
-        u64 new_commit_pos = Min(commit_size_aligned, current->chunk_cap);
-        u64 commit_size = new_commit_pos - current->chunk_commit_pos;
-
-        void *commit_ptr = (u8 *)current + current->chunk_commit_pos;
-        b32   commit_result = os_commit(commit_ptr, commit_size);
-        if (!commit_result) {
-            log_error("[arena] Failed to commit %llu bytes at %p (errno=%d)\n", commit_size, commit_ptr, errno);
-            return 0;
-        }
-        AsanUnpoisonMemoryRegion(commit_ptr, commit_size);
-        current->chunk_commit_pos = new_commit_pos;
+    if (new_pos > current->chunk_commit_pos && !arena_commit_to(arena, current, new_pos)) {
+        return 0;
     }
 
     if (new_pos > current->chunk_commit_pos) {
@@ -201,21 +270,8 @@ arena_push_no_zero(Arena *arena, u64 size) {
     if (new_pos > current->chunk_cap)
         return 0;
 
-    if (new_pos > current->chunk_commit_pos) {
-        u64 commit_size = new_pos - current->chunk_commit_pos;
-        commit_size = AlignUpPow2(commit_size, MEM_COMMIT_BLOCK_SIZE);
-        u64 new_commit_pos = current->chunk_commit_pos + commit_size;
-        if (new_commit_pos > current->chunk_cap) {
-            new_commit_pos = current->chunk_cap;
-            commit_size = new_commit_pos - current->chunk_commit_pos;
-        }
-
-        void *commit_ptr = (u8 *)current + current->chunk_commit_pos;
-        if (!os_commit(commit_ptr, commit_size)) {
-            return 0;
-        }
-        AsanUnpoisonMemoryRegion(commit_ptr, commit_size);
-        current->chunk_commit_pos = new_commit_pos;
+    if (new_pos > current->chunk_commit_pos && !arena_commit_to(arena, current, new_pos)) {
+        return 0;
     }
 
     void *result = (u8 *)current + pos_mem_aligned;
@@ -240,6 +296,10 @@ arena_pop_to(Arena *arena, u64 pos) {
                                to_free->chunk_commit_pos - MEM_INTERNAL_MIN_SIZE);
 
 #if ARENA_FREE_LIST
+        to_free->chunk_pos = MEM_INTERNAL_MIN_SIZE;
+        if (arena->flags & ArenaFlag_Decommit) {
+            arena_decommit_excess(arena, to_free);
+        }
         to_free->prev = arena->free_last;
         arena->free_last = to_free;
 #else
@@ -260,6 +320,10 @@ arena_pop_to(Arena *arena, u64 pos) {
         AsanPoisonMemoryRegion((u8 *)current + chunk_relative_pos, freed_size);
         current->chunk_pos = chunk_relative_pos;
     }
+
+    if (arena->flags & ArenaFlag_Decommit) {
+        arena_decommit_excess(arena, current);
+    }
 }
 
 static inline u64
@@ -325,10 +389,22 @@ void arena_debug_print(Arena *arena) {
     log_info("  Allocation site: %s:%d\n",
              arena->allocation_site_file ? arena->allocation_site_file : "(unknown)",
              arena->allocation_site_line);
-    log_info("  Flags: 0x%x (NoChain=%d, LargePages=%d)\n",
+    log_info("  Flags: 0x%x (NoChain=%d, LargePages=%d, NumaBind=%d, NumaInterleave=%d, Prefault=%d, CommitAhead=%d, Decommit=%d)\n",
              arena->flags,
              (arena->flags & ArenaFlag_NoChain) ? 1 : 0,
-             (arena->flags & ArenaFlag_LargePages) ? 1 : 0);
+             (arena->flags & ArenaFlag_LargePages) ? 1 : 0,
+             (arena->flags & ArenaFlag_NumaBind) ? 1 : 0,
+             (arena->flags & ArenaFlag_NumaInterleave) ? 1 : 0,
+             (arena->flags & ArenaFlag_Prefault) ? 1 : 0,
+             (arena->flags & ArenaFlag_CommitAhead) ? 1 : 0,
+             (arena->flags & ArenaFlag_Decommit) ? 1 : 0);
+    if (arena->flags & ArenaFlag_LargePages) {
+        static char *mode_names[] = {"normal", "transparent", "explicit"};
+        log_info("  Large pages: %s\n", mode_names[arena->current->large_page_mode]);
+    }
+    if (arena->flags & ArenaFlag_NumaBind) {
+        log_info("  NUMA node: %u\n", arena->numa_node);
+    }
     log_info("  Growing: %d\n", arena->growing);
     log_info("  Alignment: %u\n", arena->alignment);
     log_info("  Default reserve: %llu bytes\n", arena->default_reserve_size);
@@ -8,15 +8,31 @@
 #    define ARENA_DEBUG 0
 #endif
 
+// What os_reserve_large actually obtained.
+typedef u8 OS_Large_Page_Mode;
+enum {
+    OS_Large_Page_Mode_None,        // Normal pages
+    OS_Large_Page_Mode_Transparent, // 2MB aligned and advised, the kernel promotes pages as they fill
+    OS_Large_Page_Mode_Explicit,    // Preallocated huge pages, fully committed up front
+};
+
 void *os_reserve(u64 size);
-void *os_reserve_large(u64 size);
+void *os_reserve_large(u64 size, OS_Large_Page_Mode *mode_out);
 b32   os_commit(void *ptr, u64 size);
 void  os_decommit(void *ptr, u64 size);
+void  os_prefault(void *ptr, u64 size);
 void  os_mem_release(void *ptr, u64 size);
+b32   os_numa_bind(void *ptr, u64 size, u32 node);
+b32   os_numa_interleave(void *ptr, u64 size);
 
 typedef enum ArenaFlags {
-    ArenaFlag_NoChain = (1 << 0),    // Prevent automatic chunk chaining (fail if out of space)
-    ArenaFlag_LargePages = (1 << 1), // Use OS large pages (2MB) for better TLB performance
+    ArenaFlag_NoChain = (1 << 0),        // Prevent automatic chunk chaining (fail if out of space)
+    ArenaFlag_LargePages = (1 << 1),     // Use OS large pages (2MB) for better TLB performance
+    ArenaFlag_NumaBind = (1 << 2),       // Back every page from Arena_Params.numa_node
+    ArenaFlag_NumaInterleave = (1 << 3), // Spread pages round-robin over all NUMA nodes
+    ArenaFlag_Prefault = (1 << 4),       // Fault pages in when committing, not on first touch
+    ArenaFlag_CommitAhead = (1 << 5),    // Commit further ahead while the arena keeps growing
+    ArenaFlag_Decommit = (1 << 6),       // Give memory back after large pops, with hysteresis
 } ArenaFlags;
 
 typedef struct Arena Arena;
@@ -28,11 +44,14 @@ struct Arena {
     u64        default_commit_size;
     u16        alignment;
     b8         growing;
-    u8         filler;
+    u8         large_page_mode; // OS_Large_Page_Mode, with ArenaFlag_LargePages
+    b8         precommitted;    // Chunk is never committed or decommitted piecewise
+    u32        numa_node;
     u64        base_pos;
     u64        chunk_pos;
     u64        chunk_cap;
     u64        chunk_commit_pos;
+    u64        commit_ahead; // ArenaFlag_CommitAhead: next extra commit, on the root
 #if ARENA_FREE_LIST
     Arena *free_last;
 #endif
@@ -47,6 +66,7 @@ struct Arena {
 #define MEM_VSCRATCH_POOL_COUNT 2
 #define MEM_INITIAL_COMMIT      KB(4)
 #define MEM_INTERNAL_MIN_SIZE   AlignUpPow2(sizeof(Arena), MEM_MAX_ALIGN)
+#define MEM_COMMIT_AHEAD_MAX    MB(512)
 
 StaticAssert(sizeof(Arena) <= MEM_INITIAL_COMMIT, mem_check_arena_size);
 
@@ -69,6 +89,7 @@ struct Arena_Params {
     u64        reserve_size;
     u64        commit_size;
     u64        alignment;
+    u32        numa_node; // Only read with ArenaFlag_NumaBind
     void      *backing_buffer;
 #if ARENA_DEBUG
     char *allocation_site_file;
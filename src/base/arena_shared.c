@@ -0,0 +1,106 @@
+#include "arena_shared.h"
+
+#define SHARED_ARENA_HEADER_SIZE AlignUpPow2(sizeof(Shared_Arena_Chunk), MEM_MAX_ALIGN)
+
+static Shared_Arena_Chunk *
+shared_arena_chunk_alloc(u64 cap) {
+    Shared_Arena_Chunk *chunk = (Shared_Arena_Chunk *)os_reserve(cap);
+    if (chunk && !os_commit(chunk, cap)) {
+        os_mem_release(chunk, cap);
+        chunk = 0;
+    }
+    if (chunk) {
+        chunk->prev = 0;
+        chunk->cap = cap;
+        chunk->pos = SHARED_ARENA_HEADER_SIZE;
+    }
+    return chunk;
+}
+
+static Shared_Arena *
+shared_arena_alloc_(Shared_Arena_Params *params) {
+    u64 chunk_size = params->chunk_size ? params->chunk_size : SHARED_ARENA_CHUNK_SIZE;
+    u64 alignment = params->alignment ? params->alignment : 8;
+    u64 magazine_size = params->magazine_size ? params->magazine_size : SHARED_ARENA_MAGAZINE_SIZE;
+    Assert(IsPow2OrZero(alignment) && alignment <= MEM_MAX_ALIGN);
+
+    // The arena header sits at the start of the first chunk.
+    u64                 header = SHARED_ARENA_HEADER_SIZE + AlignUpPow2(sizeof(Shared_Arena), MEM_MAX_ALIGN);
+    Shared_Arena_Chunk *chunk = shared_arena_chunk_alloc(AlignUpPow2(Max(chunk_size, header), KB(4)));
+    Shared_Arena       *arena = 0;
+    if (chunk) {
+        arena = (Shared_Arena *)((u8 *)chunk + SHARED_ARENA_HEADER_SIZE);
+        chunk->pos = header;
+        arena->current = chunk;
+        arena->chunk_size = chunk_size;
+        arena->alignment = alignment;
+        arena->magazine_size = AlignUpPow2(magazine_size, alignment);
+    }
+    Assert(arena != 0);
+    return arena;
+}
+
+// Not thread-safe: every pusher must be done.
+static void
+shared_arena_release(Shared_Arena *arena) {
+    if (!arena)
+        return;
+
+    Shared_Arena_Chunk *chunk = arena->current;
+    while (chunk) {
+        Shared_Arena_Chunk *prev = chunk->prev;
+        os_mem_release(chunk, chunk->cap);
+        chunk = prev;
+    }
+}
+
+static void *
+shared_arena_push(Shared_Arena *arena, u64 size) {
+    if (!arena)
+        return 0;
+
+    // Rounding every size keeps every offset aligned without a second atomic.
+    u64   aligned_size = AlignUpPow2(Max(size, 1), arena->alignment);
+    void *result = 0;
+    while (!result) {
+        Shared_Arena_Chunk *chunk = (Shared_Arena_Chunk *)ins_atomic_ptr_eval(&arena->current);
+        u64                 pos = ins_atomic_u64_add_eval(&chunk->pos, aligned_size) - aligned_size;
+        if (pos + aligned_size <= chunk->cap) {
+            result = (u8 *)chunk + pos;
+            break;
+        }
+
+        // Off the end. pos only grows, so every later push to this chunk fails
+        // too and races to install the next one; exactly one CAS wins.
+        u64                 cap = AlignUpPow2(Max(arena->chunk_size, SHARED_ARENA_HEADER_SIZE + aligned_size), KB(4));
+        Shared_Arena_Chunk *next = shared_arena_chunk_alloc(cap);
+        if (!next) {
+            log_error("[arena] Failed to allocate a %llu byte shared chunk\n", cap);
+            return 0;
+        }
+        next->prev = chunk;
+        if (ins_atomic_ptr_eval_cond_assign(&arena->current, next, chunk) != chunk) {
+            os_mem_release(next, cap);
+        }
+    }
+    return result;
+}
+
+static void *
+shared_arena_push_magazine(Shared_Arena *arena, Shared_Arena_Magazine *magazine, u64 size) {
+    u64 aligned_size = AlignUpPow2(Max(size, 1), arena->alignment);
+    if ((u64)(magazine->end - magazine->pos) < aligned_size) {
+        // Big blocks skip the magazine instead of wasting most of one.
+        if (aligned_size > arena->magazine_size / 4) {
+            return shared_arena_push(arena, aligned_size);
+        }
+        magazine->pos = (u8 *)shared_arena_push(arena, arena->magazine_size);
+        magazine->end = magazine->pos ? magazine->pos + arena->magazine_size : 0;
+        if (!magazine->pos) {
+            return 0;
+        }
+    }
+    void *result = magazine->pos;
+    magazine->pos += aligned_size;
+    return result;
+}
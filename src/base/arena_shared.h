@@ -0,0 +1,59 @@
+#pragma once
+
+// Arena that any number of threads can push onto at once. Each chunk is
+// bumped with one atomic fetch-add; the thread whose push runs off the end
+// allocates the next chunk and publishes it with a compare-exchange, and a
+// thread that loses that race frees its chunk and retries on the winner's.
+// There is no pop: memory comes back zeroed and lives until release.
+//
+// Threads that push many small blocks should go through a magazine, a block
+// claimed from the shared chunk and then bumped without atomics, so the
+// shared counter sees one fetch-add per magazine instead of one per push.
+
+#define SHARED_ARENA_CHUNK_SIZE    MB(64)
+#define SHARED_ARENA_MAGAZINE_SIZE KB(64)
+
+typedef struct Shared_Arena_Chunk Shared_Arena_Chunk;
+struct Shared_Arena_Chunk {
+    Shared_Arena_Chunk *prev;
+    u64                 cap;
+    u8                  pad0[48];
+    u64                 pos; // Bumped by every pushing thread
+    u8                  pad1[56];
+};
+
+typedef struct Shared_Arena Shared_Arena;
+struct Shared_Arena {
+    Shared_Arena_Chunk *current;
+    u64                 chunk_size;
+    u64                 alignment;
+    u64                 magazine_size;
+};
+
+// Per-thread bump range carved out of a Shared_Arena. Start zeroed.
+typedef struct Shared_Arena_Magazine Shared_Arena_Magazine;
+struct Shared_Arena_Magazine {
+    u8 *pos;
+    u8 *end;
+};
+
+typedef struct Shared_Arena_Params Shared_Arena_Params;
+struct Shared_Arena_Params {
+    u64 chunk_size;
+    u64 alignment;
+    u64 magazine_size;
+};
+
+static Shared_Arena *shared_arena_alloc_(Shared_Arena_Params *params);
+static void          shared_arena_release(Shared_Arena *arena);
+static void         *shared_arena_push(Shared_Arena *arena, u64 size);
+static void         *shared_arena_push_magazine(Shared_Arena *arena, Shared_Arena_Magazine *magazine, u64 size);
+
+#define shared_arena_alloc(...) shared_arena_alloc_(&(Shared_Arena_Params){ \
+    .chunk_size = SHARED_ARENA_CHUNK_SIZE,                                  \
+    .alignment = 8,                                                         \
+    .magazine_size = SHARED_ARENA_MAGAZINE_SIZE,                            \
+    __VA_ARGS__})
+
+#define push_array_shared(a, T, c)       (T *)shared_arena_push((a), sizeof(T) * (c))
+#define push_array_magazine(a, m, T, c)  (T *)shared_arena_push_magazine((a), (m), sizeof(T) * (c))
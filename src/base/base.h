@@ -534,6 +534,18 @@ __atomic_thread_fence(__ATOMIC_SEQ_CST); 1; })
 #    error Atomic intrinsics not defined for this compiler / architecture.
 #endif
 
+// Spin-wait hint: lets the sibling hyperthread run and saves power while a
+// thread polls shared memory.
+#if COMPILER_MSVC
+#    define ins_pause() YieldProcessor()
+#elif ARCH_X64 || ARCH_X86
+#    define ins_pause() __builtin_ia32_pause()
+#elif ARCH_ARM64 || ARCH_ARM
+#    define ins_pause() __asm__ __volatile__("yield")
+#else
+#    define ins_pause() ((void)0)
+#endif
+
 #if ARCH_ADDRSIZE == 64
 #    define ins_atomic_ptr_eval_cond_assign(x, k, c) (void *)ins_atomic_u64_eval_cond_assign((u64 *)(x), (u64)(k), (u64)(c))
 #    define ins_atomic_ptr_eval_assign(x, c)         (void *)ins_atomic_u64_eval_assign((u64 *)(x), (u64)(c))
@@ -1,6 +1,7 @@
 #include "base.c"
 #include "profile.c"
 #include "arena.c"
+#include "arena_shared.c"
 #include "base_tctx.c"
 #include "string_core.c"
 #include "format.c"
@@ -8,6 +9,9 @@
 #include "logger.c"
 #include "math.c"
 #include "base_thread.c"
+#include "base_job.c"
+#include "pool.c"
+#include "string_intern.c"
 
 #if USE_NEON
 #include "simd_neon.c"
@@ -17,4 +21,6 @@
 #include "simd_scalar.c"
 #endif
 
+#include "hash_map.c"
 #include "sort.c"
+#include "union_find.c"
@@ -3,12 +3,18 @@
 #include "base.h"
 #include "profile.h"
 #include "arena.h"
+#include "arena_shared.h"
 #include "string_core.h"
 #include "format.h"
-#include "cmd_line.h"
+#include "hash_map.h"
 #include "logger.h"
 #include "math.h"
 #include "base_thread.h"
+#include "pool.h"
 #include "base_tctx.h"
+#include "base_job.h"
+#include "string_intern.h"
+#include "cmd_line.h"
 #include "simd.h"
 #include "sort.h"
+#include "union_find.h"
@@ -0,0 +1,247 @@
+#include "base_job.h"
+
+static Job_System         *job_system_state = 0;
+thread_static Job_Worker *job_worker_local = 0;
+
+static b32
+job_deque_push(Job_Deque *deque, Job job) {
+    u64 b = ins_atomic_u64_eval(&deque->bottom);
+    u64 t = ins_atomic_u64_eval(&deque->top);
+    if (b - t >= JOB_DEQUE_CAPACITY) {
+        return 0;
+    }
+    deque->jobs[b & (JOB_DEQUE_CAPACITY - 1)] = job;
+    ins_atomic_u64_eval_assign(&deque->bottom, b + 1);
+    return 1;
+}
+
+static b32
+job_deque_pop(Job_Deque *deque, Job *out) {
+    u64 b = ins_atomic_u64_eval(&deque->bottom) - 1;
+    ins_atomic_u64_eval_assign(&deque->bottom, b);
+    u64 t = ins_atomic_u64_eval(&deque->top);
+    if ((s64)(b - t) < 0) {
+        ins_atomic_u64_eval_assign(&deque->bottom, b + 1);
+        return 0;
+    }
+
+    *out = deque->jobs[b & (JOB_DEQUE_CAPACITY - 1)];
+    if (b != t) {
+        return 1;
+    }
+
+    // Last job: race any thief for it through top.
+    b32 won = ins_atomic_u64_eval_cond_assign(&deque->top, t + 1, t) == t;
+    ins_atomic_u64_eval_assign(&deque->bottom, b + 1);
+    return won;
+}
+
+static b32
+job_deque_steal(Job_Deque *deque, Job *out) {
+    u64 t = ins_atomic_u64_eval(&deque->top);
+    u64 b = ins_atomic_u64_eval(&deque->bottom);
+    if ((s64)(b - t) <= 0) {
+        return 0;
+    }
+
+    // The slot can only be reused once top moves past it, in which case the
+    // CAS fails and the copy is thrown away.
+    Job job = deque->jobs[t & (JOB_DEQUE_CAPACITY - 1)];
+    if (ins_atomic_u64_eval_cond_assign(&deque->top, t + 1, t) != t) {
+        return 0;
+    }
+    *out = job;
+    return 1;
+}
+
+static b32
+job_next(Job_Worker *worker, Job *out) {
+    Job_System *js = job_system_state;
+    b32 found = job_deque_pop(&worker->deque, out);
+
+    if (!found && js->worker_count > 1) {
+        worker->rng ^= worker->rng << 13;
+        worker->rng ^= worker->rng >> 7;
+        worker->rng ^= worker->rng << 17;
+        u64 first = worker->rng % js->worker_count;
+        for (u64 i = 0; i < js->worker_count && !found; i++) {
+            Job_Worker *victim = &js->workers[(first + i) % js->worker_count];
+            if (victim != worker) {
+                found = job_deque_steal(&victim->deque, out);
+            }
+        }
+    }
+
+    if (found) {
+        ins_atomic_u64_dec_eval(&js->queued);
+    }
+    return found;
+}
+
+static void
+job_run(Job *job) {
+    job->func(job->data);
+    if (ins_atomic_u64_dec_eval(&job->counter->pending) != 0) {
+        return;
+    }
+
+    // Waiters can't tell whose counter finished, so wake all of them.
+    Job_System *js = job_system_state;
+    if (js) {
+        u64 waiters = ins_atomic_u64_eval(&js->waiters);
+        for (u64 i = 0; i < waiters; i++) {
+            semaphore_drop(js->done);
+        }
+    }
+}
+
+static void
+job_worker_entry_point(void *ptr) {
+    Job_Worker *worker = (Job_Worker *)ptr;
+    TCTX       *tctx = tctx_alloc();
+    tctx_select(tctx);
+    tctx_set_thread_name(str_lit("Job Worker"));
+    job_worker_local = worker;
+
+    Job_System *js = job_system_state;
+    u64         idle_rounds = 0;
+    for (;;) {
+        Job job;
+        if (job_next(worker, &job)) {
+            job_run(&job);
+            idle_rounds = 0;
+            continue;
+        }
+        if (!ins_atomic_u32_eval(&js->running)) {
+            break;
+        }
+        if (++idle_rounds < JOB_SPIN_ROUNDS) {
+            ins_pause();
+            continue;
+        }
+
+        // Spawners bump queued before they read sleepers, and sleepers is
+        // bumped here before queued is read, so one side always sees the
+        // other. A surplus wake just costs one extra empty round.
+        ins_atomic_u64_inc_eval(&js->sleepers);
+        if (ins_atomic_u64_eval(&js->queued) == 0 && ins_atomic_u32_eval(&js->running)) {
+            semaphore_take(js->wake, MAX_U64);
+        }
+        ins_atomic_u64_dec_eval(&js->sleepers);
+        idle_rounds = 0;
+    }
+
+    job_worker_local = 0;
+    tctx_release(tctx);
+}
+
+void
+job_system_init(Arena *arena, u64 worker_count) {
+    if (worker_count == 0) {
+        worker_count = os_get_system_info()->logical_processors;
+    }
+    worker_count = Max(worker_count, 1);
+
+    Job_System *js = push_array(arena, Job_System, 1);
+    js->workers = push_array(arena, Job_Worker, worker_count);
+    js->worker_count = worker_count;
+    js->running = 1;
+    js->wake = semaphore_alloc(0, (u32)worker_count * JOB_DEQUE_CAPACITY, str_lit(""));
+    js->done = semaphore_alloc(0, (u32)worker_count * JOB_DEQUE_CAPACITY, str_lit(""));
+    for (u64 i = 0; i < worker_count; i++) {
+        Job_Worker *worker = &js->workers[i];
+        worker->idx = i;
+        worker->rng = hash_u64(i + 1) | 1;
+        worker->deque.jobs = push_array_no_zero(arena, Job, JOB_DEQUE_CAPACITY);
+    }
+    job_system_state = js;
+    job_worker_local = &js->workers[0];
+
+    for (u64 i = 1; i < worker_count; i++) {
+        js->workers[i].thread = thread_launch(job_worker_entry_point, &js->workers[i]);
+    }
+}
+
+void
+job_system_shutdown(void) {
+    Job_System *js = job_system_state;
+    if (!js) {
+        return;
+    }
+    ins_atomic_u32_eval_assign(&js->running, 0);
+    for (u64 i = 1; i < js->worker_count; i++) {
+        semaphore_drop(js->wake);
+    }
+    for (u64 i = 1; i < js->worker_count; i++) {
+        thread_join(js->workers[i].thread, MAX_U64);
+    }
+    semaphore_release(js->wake);
+    semaphore_release(js->done);
+    job_worker_local = 0;
+    job_system_state = 0;
+}
+
+void
+job_spawn(Job_Counter *counter, Job_Func *func, void *data) {
+    Job job = {func, data, counter};
+    ins_atomic_u64_inc_eval(&counter->pending);
+
+    Job_System *js = job_system_state;
+    Job_Worker *worker = job_worker_local;
+    if (!js || !worker) {
+        job_run(&job);
+        return;
+    }
+
+    ins_atomic_u64_inc_eval(&js->queued);
+    if (!job_deque_push(&worker->deque, job)) {
+        ins_atomic_u64_dec_eval(&js->queued);
+        job_run(&job);
+        return;
+    }
+    if (ins_atomic_u64_eval(&js->sleepers) > 0) {
+        semaphore_drop(js->wake);
+    }
+}
+
+void
+job_wait(Job_Counter *counter) {
+    Job_System *js = job_system_state;
+    Job_Worker *worker = job_worker_local;
+    u64         idle_rounds = 0;
+    while (ins_atomic_u64_eval(&counter->pending) != 0) {
+        Job job;
+        if (worker && job_next(worker, &job)) {
+            job_run(&job);
+            idle_rounds = 0;
+            continue;
+        }
+        if (!js || ++idle_rounds < JOB_SPIN_ROUNDS) {
+            ins_pause();
+            continue;
+        }
+
+        // The workers' handshake, on done: job_run drops pending before it
+        // reads waiters, and waiters is bumped here before pending is read.
+        // A waiter can still lose its wake to one that re-slept, so the sleep
+        // is bounded and the loop checks again.
+        ins_atomic_u64_inc_eval(&js->waiters);
+        if (ins_atomic_u64_eval(&counter->pending) != 0) {
+            semaphore_take(js->done, os_now_microseconds() + JOB_WAIT_SLEEP_US);
+        }
+        ins_atomic_u64_dec_eval(&js->waiters);
+        idle_rounds = 0;
+    }
+}
+
+u64
+job_worker_idx(void) {
+    Job_Worker *worker = job_worker_local;
+    return worker ? worker->idx : 0;
+}
+
+u64
+job_worker_count(void) {
+    Job_System *js = job_system_state;
+    return js ? js->worker_count : 1;
+}
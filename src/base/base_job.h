@@ -0,0 +1,72 @@
+#pragma once
+
+// Work-stealing job system. A persistent pool of workers, each owning a
+// Chase-Lev deque: the owner pushes and pops at the bottom, idle workers
+// steal from the top. The thread that calls job_system_init becomes worker 0
+// and runs jobs whenever it waits on a counter. Every other worker selects
+// its own TCTX, so its scratch arenas live as long as the pool.
+
+#define JOB_DEQUE_CAPACITY 4096 // Power of two
+#define JOB_SPIN_ROUNDS    64   // Failed steal rounds before a worker or waiter sleeps
+#define JOB_WAIT_SLEEP_US  1000 // Longest a blocked job_wait sleeps between checks
+
+typedef void Job_Func(void *data);
+
+// Fork-join handle: the number of jobs spawned against it still unfinished.
+typedef struct Job_Counter Job_Counter;
+struct Job_Counter {
+    u64 pending;
+};
+
+typedef struct Job Job;
+struct Job {
+    Job_Func    *func;
+    void        *data;
+    Job_Counter *counter;
+};
+
+typedef struct Job_Deque Job_Deque;
+struct Job_Deque {
+    u64  top; // Thieves take from here
+    u8   pad0[56];
+    u64  bottom; // Owner pushes and pops here
+    u8   pad1[56];
+    Job *jobs;
+};
+
+typedef struct Job_Worker Job_Worker;
+struct Job_Worker {
+    Job_Deque deque;
+    u64       idx;
+    u64       rng;
+    Thread    thread;
+};
+
+typedef struct Job_System Job_System;
+struct Job_System {
+    Job_Worker *workers;
+    u64         worker_count;
+    u32         running;
+    Semaphore   wake;
+    u8          pad0[64];
+    u64         queued; // Jobs sitting in any deque
+    u8          pad1[56];
+    u64         sleepers; // Workers blocked on wake
+    u8          pad2[56];
+    u64         waiters; // job_wait callers blocked on done
+    Semaphore   done;
+};
+
+void job_system_init(Arena *arena, u64 worker_count);
+void job_system_shutdown(void);
+
+// Runs func(data) on some worker. Called off the pool, or with the owner's
+// deque full, the job runs inline before job_spawn returns.
+void job_spawn(Job_Counter *counter, Job_Func *func, void *data);
+// Runs queued jobs until every job spawned against counter has finished.
+// With nothing left to run it spins briefly, then blocks until some counter
+// reaches zero.
+void job_wait(Job_Counter *counter);
+
+u64 job_worker_idx(void);
+u64 job_worker_count(void);
@@ -10,6 +10,7 @@ tctx_alloc(void) {
 }
 
 void tctx_release(TCTX *tctx) {
+    pool_cache_flush(&tctx->pool_cache);
     arena_release(tctx->arenas[1]);
     arena_release(tctx->arenas[0]);
 }
@@ -63,13 +64,24 @@ tctx_get_thread_name(void) {
     return result;
 }
 
+// Zeroed and cache-line aligned, so each lane's slot sits alone on its line.
+Lane_Slot *
+tctx_lane_slots_alloc(Arena *arena, u64 lane_count) {
+    u64 count = LANE_SLOT_COUNT(lane_count);
+    u8 *base = push_array(arena, u8, (count + 1) * sizeof(Lane_Slot));
+    return (Lane_Slot *)PtrFromInt(AlignUpPow2(IntFromPtr(base), sizeof(Lane_Slot)));
+}
+
 void
-tctx_lane_init(u64 lane_idx, u64 lane_count, Barrier barrier, void *broadcast_mem) {
+tctx_lane_init(u64 lane_idx, u64 lane_count, Barrier barrier, void *broadcast_mem, Lane_Slot *slots) {
     TCTX *tctx = tctx_selected();
     tctx->lane_ctx.lane_idx = lane_idx;
     tctx->lane_ctx.lane_count = lane_count;
     tctx->lane_ctx.barrier = barrier;
     tctx->lane_ctx.broadcast_memory = broadcast_mem;
+    tctx->lane_ctx.slots = slots;
+    tctx->lane_ctx.slot_phase = 0;
+    tctx->lane_ctx.cursor_base = 0;
 }
 
 void
@@ -123,3 +135,202 @@ tctx_lane_range(u64 total_count) {
 	
     return result;
 }
+
+// Writes one byte per page of this lane's lane_range slice of an array that
+// has not been touched yet (push_array_no_zero on fresh memory). Under the
+// default first-touch policy each page then lives on the node of the lane
+// whose static slice covers it. That needs 4KB pages: a lane faulting a
+// large page places all of it, whoever's slices it covers. Synchronizes
+// before returning.
+void
+tctx_lane_first_touch(void *base, u64 count, u64 elem_size) {
+    Rng1U64 range = tctx_lane_range(count);
+    u8     *first = (u8 *)base + range.min * elem_size;
+    u8     *opl = (u8 *)base + range.max * elem_size;
+    u8     *page = (u8 *)PtrFromInt(AlignUpPow2(IntFromPtr(first), KB(4)));
+    if (first < opl && page != first) {
+        *(volatile u8 *)first = 0;
+    }
+    for (; page < opl; page += KB(4)) {
+        *(volatile u8 *)page = 0;
+    }
+    tctx_lane_sync(0, 0, 0);
+}
+
+// Words of each Lane_Slot. Reductions alternate between two words, so a lane
+// can only overwrite one after every lane has passed the next reduction's
+// barrier, which means they are done reading it. That leaves one barrier per
+// reduction. The scan and the pointer exchanges end on a barrier of their own.
+#define LANE_SLOT_REDUCE  0 // and 1
+#define LANE_SLOT_SCAN    2
+#define LANE_SLOT_POINTER 3
+
+// Exclusive prefix sum over a shared array, in place. Every lane must call
+// it. Each lane scans its lane_range slice, publishes the slice total in its
+// slot, then offsets its slice by the totals of the lanes before it. Returns
+// the sum of all values, and the whole array is final on return.
+u64
+tctx_lane_scan_u64(u64 *values, u64 count) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+
+    if (lane->lane_count <= 1) {
+        u64 total = 0;
+        for (u64 i = 0; i < count; i++) {
+            u64 c = values[i];
+            values[i] = total;
+            total += c;
+        }
+        return total;
+    }
+    Assert(lane->slots != 0);
+
+    Rng1U64 range = tctx_lane_range(count);
+    u64 sum = 0;
+    for (u64 i = range.min; i < range.max; i++) {
+        sum += values[i];
+    }
+    lane->slots[lane->lane_idx].v[LANE_SLOT_SCAN] = sum;
+    tctx_lane_sync(0, 0, 0);
+
+    u64 offset = 0;
+    u64 total = 0;
+    for (u64 i = 0; i < lane->lane_count; i++) {
+        u64 lane_sum = lane->slots[i].v[LANE_SLOT_SCAN];
+        if (i < lane->lane_idx) {
+            offset += lane_sum;
+        }
+        total += lane_sum;
+    }
+    for (u64 i = range.min; i < range.max; i++) {
+        u64 c = values[i];
+        values[i] = offset;
+        offset += c;
+    }
+
+    // Slots are reused by the next scan, so nobody may leave before every
+    // lane has read them.
+    tctx_lane_sync(0, 0, 0);
+    return total;
+}
+
+u64
+tctx_lane_reduce_u64(u64 value, Lane_Reduce_Op op) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+    if (lane->lane_count <= 1) {
+        return value;
+    }
+    Assert(lane->slots != 0);
+
+    u64 word = LANE_SLOT_REDUCE + (lane->slot_phase & 1);
+    lane->slot_phase += 1;
+    lane->slots[lane->lane_idx].v[word] = value;
+    tctx_lane_sync(0, 0, 0);
+
+    u64 result = lane->slots[0].v[word];
+    for (u64 i = 1; i < lane->lane_count; i++) {
+        u64 v = lane->slots[i].v[word];
+        switch (op) {
+        case Lane_Reduce_Op_Sum: result += v; break;
+        case Lane_Reduce_Op_Min: result = Min(result, v); break;
+        case Lane_Reduce_Op_Max: result = Max(result, v); break;
+        }
+    }
+    return result;
+}
+
+// Copies size bytes from the source lane's ptr into every other lane's ptr.
+// Unlike lane_sync_u64 there is no size limit: lanes read straight out of the
+// source lane's buffer, which has to stay put until the closing barrier.
+void
+tctx_lane_broadcast(void *ptr, u64 size, u64 src_lane_idx) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+    if (lane->lane_count <= 1) {
+        return;
+    }
+    Assert(lane->slots != 0);
+
+    if (lane->lane_idx == src_lane_idx) {
+        lane->slots[src_lane_idx].v[LANE_SLOT_POINTER] = IntFromPtr(ptr);
+    }
+    tctx_lane_sync(0, 0, 0);
+    if (lane->lane_idx != src_lane_idx) {
+        MemoryCopy(ptr, PtrFromInt(lane->slots[src_lane_idx].v[LANE_SLOT_POINTER]), size);
+    }
+    tctx_lane_sync(0, 0, 0);
+}
+
+// Every lane ends up with every lane's value: lane i's size bytes land at
+// out + i*size, so out needs lane_count*size bytes.
+void
+tctx_lane_gather(void *value, u64 size, void *out) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+    if (lane->lane_count <= 1) {
+        MemoryCopy(out, value, size);
+        return;
+    }
+    Assert(lane->slots != 0);
+
+    lane->slots[lane->lane_idx].v[LANE_SLOT_POINTER] = IntFromPtr(value);
+    tctx_lane_sync(0, 0, 0);
+    for (u64 i = 0; i < lane->lane_count; i++) {
+        MemoryCopy((u8 *)out + i * size, PtrFromInt(lane->slots[i].v[LANE_SLOT_POINTER]), size);
+    }
+    tctx_lane_sync(0, 0, 0);
+}
+
+// The shared counter never resets. Each cursor claims the next count values
+// of it, and since a lane only moves on once it has seen the previous cursor
+// drained, the counter already sits at this cursor's base when any lane
+// reaches it. Claims are a compare-exchange clamped to the end, so a lane
+// still draining an old cursor can never take values from the next one.
+Lane_Cursor
+tctx_lane_cursor(u64 count, u64 chunk, b32 guided) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+    Lane_Cursor result = {lane->cursor_base, count, Max(chunk, 1), guided};
+    lane->cursor_base += count;
+    return result;
+}
+
+// Next chunk of the cursor, or an empty range once it is drained. Guided
+// cursors start with chunks of remaining / (2 * lane_count) and shrink
+// towards `chunk`, so the tail still balances without a claim per item.
+Rng1U64
+tctx_lane_cursor_next(Lane_Cursor *cursor) {
+    TCTX *tctx = tctx_selected();
+    Lane_Ctx *lane = &tctx->lane_ctx;
+    Rng1U64 result = {0};
+
+    if (lane->lane_count <= 1) {
+        // A single lane takes everything in one chunk.
+        result.max = cursor->count;
+        cursor->count = 0;
+        return result;
+    }
+    Assert(lane->slots != 0);
+
+    u64 end = cursor->base + cursor->count;
+    u64 *counter = &lane->slots[lane->lane_count].v[0];
+    u64 pos = ins_atomic_u64_eval(counter);
+    for (;;) {
+        if (pos >= end) {
+            return result;
+        }
+        u64 take = cursor->chunk;
+        if (cursor->guided) {
+            take = Max(take, (end - pos) / (2 * lane->lane_count));
+        }
+        u64 next = Min(pos + take, end);
+        u64 prev = ins_atomic_u64_eval_cond_assign(counter, next, pos);
+        if (prev == pos) {
+            result.min = pos - cursor->base;
+            result.max = next - cursor->base;
+            return result;
+        }
+        pos = prev;
+    }
+}
@@ -1,12 +1,44 @@
 #pragma once
+// One cache line of shared scratch per lane, so lanes can publish partial
+// results without false sharing. That only holds if the array is line
+// aligned: allocate it with tctx_lane_slots_alloc.
+typedef struct Lane_Slot Lane_Slot;
+struct Lane_Slot {
+    u64 v[8];
+};
+
 typedef struct Lane_Ctx Lane_Ctx;
 struct Lane_Ctx {
-    u64     lane_idx;         // This thread's lane index (0-based)
-    u64     lane_count;       // Total number of lanes
-    Barrier barrier;          // Sync point for lane_sync()
-    void   *broadcast_memory; // Shared buffer for broadcasting (64 bytes)
+    u64        lane_idx;         // This thread's lane index (0-based)
+    u64        lane_count;       // Total number of lanes
+    Barrier    barrier;          // Sync point for lane_sync()
+    void      *broadcast_memory; // Shared buffer for broadcasting (64 bytes)
+    Lane_Slot *slots;            // Shared, LANE_SLOT_COUNT(lane_count) entries
+    u64        slot_phase;       // Alternates the word lane reductions use
+    u64        cursor_base;      // Where the next lane cursor starts
+};
+
+// One slot per lane plus a shared one holding the lane cursor. The slots must
+// start zeroed, and serve one lane group: the cursor counter never resets, so
+// lanes set up again with tctx_lane_init need fresh slots.
+#define LANE_SLOT_COUNT(lane_count) ((lane_count) + 1)
+
+// Hands out chunks of [0, count) from a counter shared by all lanes. Every
+// lane must build the same cursors in the same order and drain each one.
+typedef struct Lane_Cursor Lane_Cursor;
+struct Lane_Cursor {
+    u64 base;
+    u64 count;
+    u64 chunk;
+    b32 guided;
 };
 
+typedef enum Lane_Reduce_Op {
+    Lane_Reduce_Op_Sum,
+    Lane_Reduce_Op_Min,
+    Lane_Reduce_Op_Max,
+} Lane_Reduce_Op;
+
 typedef struct Rng1U64 Rng1U64;
 struct Rng1U64 {
     u64 min;
@@ -15,10 +47,11 @@ struct Rng1U64 {
 
 typedef struct TCTX TCTX;
 struct TCTX {
-    Arena   *arenas[2];
-    u8       thread_name[32];
-    u64      thread_name_size;
-    Lane_Ctx lane_ctx;
+    Arena     *arenas[2];
+    u8         thread_name[32];
+    u64        thread_name_size;
+    Lane_Ctx   lane_ctx;
+    Pool_Cache pool_cache; // This thread's blocks of whichever pool it last used
 };
 
 TCTX               *tctx_alloc(void);
@@ -34,9 +67,17 @@ Arena *tctx_get_scratch(Arena **conflicts, u64 count);
 void   tctx_set_thread_name(String name);
 String tctx_get_thread_name(void);
 
-void    tctx_lane_init(u64 lane_idx, u64 lane_count, Barrier barrier, void *broadcast_mem);
+void    tctx_lane_init(u64 lane_idx, u64 lane_count, Barrier barrier, void *broadcast_mem, Lane_Slot *slots);
+Lane_Slot *tctx_lane_slots_alloc(Arena *arena, u64 lane_count);
 void    tctx_lane_sync(void *broadcast_ptr, u64 broadcast_size, u64 broadcast_src_lane_idx);
 Rng1U64 tctx_lane_range(u64 total_count);
+void    tctx_lane_first_touch(void *base, u64 count, u64 elem_size);
+u64     tctx_lane_scan_u64(u64 *values, u64 count);
+u64     tctx_lane_reduce_u64(u64 value, Lane_Reduce_Op op);
+void    tctx_lane_broadcast(void *ptr, u64 size, u64 src_lane_idx);
+void    tctx_lane_gather(void *value, u64 size, void *out);
+Lane_Cursor tctx_lane_cursor(u64 count, u64 chunk, b32 guided);
+Rng1U64 tctx_lane_cursor_next(Lane_Cursor *cursor);
 
 #define lane_idx()                   (tctx_selected()->lane_ctx.lane_idx)
 #define lane_count()                 (tctx_selected()->lane_ctx.lane_count)
@@ -44,3 +85,14 @@ Rng1U64 tctx_lane_range(u64 total_count);
 #define lane_sync()                  tctx_lane_sync(0, 0, 0)
 #define lane_sync_u64(ptr, src_lane) tctx_lane_sync((ptr), sizeof(u64), (src_lane))
 #define lane_range(count)            tctx_lane_range(count)
+#define lane_first_touch(ptr, count) tctx_lane_first_touch((ptr), (count), sizeof(*(ptr)))
+#define lane_scan_u64(values, count) tctx_lane_scan_u64((values), (count))
+#define lane_reduce_sum_u64(value)   tctx_lane_reduce_u64((value), Lane_Reduce_Op_Sum)
+#define lane_reduce_min_u64(value)   tctx_lane_reduce_u64((value), Lane_Reduce_Op_Min)
+#define lane_reduce_max_u64(value)   tctx_lane_reduce_u64((value), Lane_Reduce_Op_Max)
+#define lane_broadcast(ptr, size, src_lane) tctx_lane_broadcast((ptr), (size), (src_lane))
+#define lane_gather(ptr, size, out)  tctx_lane_gather((ptr), (size), (out))
+#define lane_range_dynamic(count, chunk)    tctx_lane_cursor((count), (chunk), 0)
+#define lane_range_guided(count, min_chunk) tctx_lane_cursor((count), (min_chunk), 1)
+#define EachLaneChunk(range, cursor) \
+    (Rng1U64 range = tctx_lane_cursor_next(&(cursor)); range.min < range.max; range = tctx_lane_cursor_next(&(cursor)))
@@ -16,6 +16,11 @@ void thread_detach(Thread thread) {
     os_thread_detach(thread);
 }
 
+b32 thread_set_affinity(Thread thread, u32 cpu_idx) {
+    b32 result = os_thread_set_affinity(thread, cpu_idx);
+    return result;
+}
+
 Mutex mutex_alloc(void) {
     Mutex result = os_mutex_alloc();
     return result;
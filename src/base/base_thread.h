@@ -6,6 +6,7 @@
 Thread thread_launch(Thread_Entry_Point *f, void *p);
 b32    thread_join(Thread thread, u64 endt_us);
 void   thread_detach(Thread thread);
+b32    thread_set_affinity(Thread thread, u32 cpu_idx);
 
 Mutex mutex_alloc(void);
 void  mutex_release(Mutex mutex);
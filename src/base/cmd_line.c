@@ -1,26 +1,3 @@
-static Cmd_Line_Opt **
-cmd_line_slot_from_string(Cmd_Line *cmd_line, String string) {
-    Cmd_Line_Opt **slot = 0;
-    if (cmd_line->option_table_size != 0) {
-        u64 hash = u64_hash_from_str(string);
-        u64 bucket = hash % cmd_line->option_table_size;
-        slot = &cmd_line->option_table[bucket];
-    }
-    return slot;
-}
-
-static Cmd_Line_Opt *
-cmd_line_opt_from_slot(Cmd_Line_Opt **slot, String string) {
-    Cmd_Line_Opt *result = 0;
-    for (Cmd_Line_Opt *var = *slot; var; var = var->hash_next) {
-        if (str_match(string, var->string, 0)) {
-            result = var;
-            break;
-        }
-    }
-    return result;
-}
-
 static void
 cmd_line_push_opt(Cmd_Line_Opt_List *list, Cmd_Line_Opt *var) {
     SLLQueuePush(list->first, list->last, var);
@@ -29,23 +6,21 @@ cmd_line_push_opt(Cmd_Line_Opt_List *list, Cmd_Line_Opt *var) {
 
 static Cmd_Line_Opt *
 cmd_line_insert_opt(Arena *arena, Cmd_Line *cmd_line, String string, String_List values) {
-    Cmd_Line_Opt  *var = 0;
-    Cmd_Line_Opt **slot = cmd_line_slot_from_string(cmd_line, string);
-    Cmd_Line_Opt  *existing_var = cmd_line_opt_from_slot(slot, string);
-    if (existing_var != 0) {
-        var = existing_var;
-    } else {
+    // A name the interner hasn't seen can't be in the table yet.
+    u32           known_count = str_intern_count(cmd_line->option_names);
+    u32           name_id = str_intern(cmd_line->option_names, string);
+    Cmd_Line_Opt *var = name_id < known_count ? cmd_line_opt_from_string(cmd_line, string) : 0;
+    if (var == 0) {
         var = push_array(arena, Cmd_Line_Opt, 1);
-        var->hash_next = *slot;
-        var->hash = u64_hash_from_str(string);
-        var->string = str_push_copy(arena, string);
+        var->name_id = name_id;
+        var->string = str_from_intern_id(cmd_line->option_names, name_id);
         var->value_strings = values;
         String_Join join = {0};
         join.pre = str_lit("");
         join.mid = str_lit(",");
         join.post = str_lit("");
         var->value_string = str_list_join(arena, &var->value_strings, &join);
-        *slot = var;
+        hash_map_str_ptr_put(&cmd_line->option_table, var->string, var);
         cmd_line_push_opt(&cmd_line->options, var);
     }
     return var;
@@ -55,8 +30,8 @@ static Cmd_Line
 cmd_line_from_string_list(Arena *arena, String_List command_line) {
     Cmd_Line parsed = {0};
     parsed.exe_name = command_line.first->string;
-    parsed.option_table_size = 64;
-    parsed.option_table = push_array(arena, Cmd_Line_Opt *, parsed.option_table_size);
+    parsed.option_names = str_interner_alloc();
+    parsed.option_table = hash_map_str_ptr_alloc(arena, 64);
 	
     b32 after_passthrough_option = 0;
     b32 first_passthrough = 1;
@@ -137,7 +112,8 @@ cmd_line_from_string_list(Arena *arena, String_List command_line) {
 
 static Cmd_Line_Opt *
 cmd_line_opt_from_string(Cmd_Line *cmd_line, String name) {
-    return cmd_line_opt_from_slot(cmd_line_slot_from_string(cmd_line, name), name);
+    Cmd_Line_Opt **slot = (Cmd_Line_Opt **)hash_map_str_ptr_get(&cmd_line->option_table, name);
+    return slot ? *slot : 0;
 }
 
 static String_List
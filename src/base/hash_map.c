@@ -0,0 +1,78 @@
+static inline u32
+hash_map_lowest_bit(u32 mask) {
+#if COMPILER_CLANG || COMPILER_GCC
+    return (u32)__builtin_ctz(mask);
+#elif COMPILER_MSVC
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (u32)idx;
+#else
+    u32 result = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        result++;
+    }
+    return result;
+#endif
+}
+
+// One bit per slot of the group whose control byte equals tag.
+static inline u32
+hash_map_group_match(const u8 *group, u8 tag) {
+    Simd_V16u8 ctrl = simd_loadu_u8(group);
+    return simd_movemask_u8(simd_cmpeq_u8(ctrl, simd_set1_u8(tag)));
+}
+
+static inline u32
+hash_map_group_match_empty(const u8 *group) {
+    return hash_map_group_match(group, HASH_MAP_CTRL_EMPTY);
+}
+
+// EMPTY and DELETED are the only bytes with the high bit set.
+static inline u32
+hash_map_group_match_free(const u8 *group) {
+    return simd_movemask_u8(simd_loadu_u8(group));
+}
+
+static u8 *
+hash_map_ctrl_alloc(Arena *arena, u64 cap) {
+    u8 *ctrl = push_array_no_zero(arena, u8, cap);
+    memset(ctrl, HASH_MAP_CTRL_EMPTY, cap);
+    return ctrl;
+}
+
+// Smallest power of two that holds count under the 7/8 load limit.
+static u64
+hash_map_cap_from_count(u64 count) {
+    u64 cap = HASH_MAP_MIN_CAP;
+    while (cap * 7 / 8 < count) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+// The multiply leaves the low bits (which pick the group) depending only on
+// the key's low bits, so fold the well-mixed high half down onto them.
+static inline u64
+hash_map_hash_u64(u64 key) {
+    u64 hash = hash_u64(key);
+    return hash ^ (hash >> 32);
+}
+
+static inline b32
+hash_map_eq_u64(u64 a, u64 b) {
+    return a == b;
+}
+
+static inline u64
+hash_map_hash_str(String key) {
+    return u64_hash_from_str(key);
+}
+
+static inline b32
+hash_map_eq_str(String a, String b) {
+    return str_match(a, b, 0);
+}
+
+HASH_MAP_DEFINE(u64, u64, u64, hash_map_hash_u64, hash_map_eq_u64)
+HASH_MAP_STR_DEFINE(str_ptr, void *)
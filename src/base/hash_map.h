@@ -0,0 +1,197 @@
+#pragma once
+
+// Swiss-table style open-addressing map. Slots are split into groups of 16,
+// each with a control byte per slot: EMPTY, DELETED, or the top 7 bits of
+// the key's hash when full. A lookup hashes once, loads the 16 control bytes
+// of a group, and compares them all to the 7-bit tag with one
+// simd_cmpeq_u8 + simd_movemask_u8, so only slots whose tag matches ever
+// have their key compared. Probing moves group to group (triangular steps,
+// which visit every group of a power-of-two table) and stops at the first
+// group holding an EMPTY byte.
+//
+// Storage comes from an Arena. Growing allocates a table twice the size and
+// leaves the old one behind in the arena, the same trade every arena
+// structure makes. Keys are stored as given: String keys must outlive the
+// map (copy them into the arena first if they don't).
+//
+// HASH_MAP_DECLARE(name, K, V) emits the types and prototypes, and
+// HASH_MAP_DEFINE(name, K, V, hash_func, eq_func) the bodies, which need the
+// SIMD backend so they go in a .c file included after it:
+//
+//   Hash_Map_<name> hash_map_<name>_alloc(Arena *arena, u64 expected_count)
+//   V  *hash_map_<name>_get(Hash_Map_<name> *map, K key)       - 0 if absent
+//   V  *hash_map_<name>_insert(Hash_Map_<name> *map, K key, b32 *is_new)
+//                                               - new values start zeroed
+//   V  *hash_map_<name>_put(Hash_Map_<name> *map, K key, V value)
+//   b32 hash_map_<name>_remove(Hash_Map_<name> *map, K key)
+//
+// Full slots are those with ctrl[i] < HASH_MAP_CTRL_EMPTY, for iteration.
+
+#define HASH_MAP_GROUP_WIDTH  16
+#define HASH_MAP_MIN_CAP      16
+#define HASH_MAP_CTRL_EMPTY   0x80
+#define HASH_MAP_CTRL_DELETED 0xFE
+
+static inline u32 hash_map_lowest_bit(u32 mask);
+static inline u32 hash_map_group_match(const u8 *group, u8 tag);
+static inline u32 hash_map_group_match_empty(const u8 *group);
+static inline u32 hash_map_group_match_free(const u8 *group);
+static u8        *hash_map_ctrl_alloc(Arena *arena, u64 cap);
+static u64        hash_map_cap_from_count(u64 count);
+
+static inline u64 hash_map_hash_u64(u64 key);
+static inline b32 hash_map_eq_u64(u64 a, u64 b);
+static inline u64 hash_map_hash_str(String key);
+static inline b32 hash_map_eq_str(String a, String b);
+
+#define HASH_MAP_DECLARE(name, K, V)                                                          \
+    typedef struct Hash_Map_##name##_Slot Hash_Map_##name##_Slot;                             \
+    struct Hash_Map_##name##_Slot {                                                           \
+        K key;                                                                                \
+        V value;                                                                              \
+    };                                                                                        \
+    typedef struct Hash_Map_##name Hash_Map_##name;                                           \
+    struct Hash_Map_##name {                                                                  \
+        Arena                  *arena;                                                        \
+        u8                     *ctrl;                                                         \
+        Hash_Map_##name##_Slot *slots;                                                        \
+        u64                     cap;   /* Power of two, multiple of the group width */        \
+        u64                     count; /* Full slots */                                       \
+        u64                     used;  /* Full plus deleted: what the load limit counts */    \
+    };                                                                                        \
+    static Hash_Map_##name hash_map_##name##_alloc(Arena *arena, u64 expected_count);         \
+    static V  *hash_map_##name##_get(Hash_Map_##name *map, K key);                            \
+    static V  *hash_map_##name##_insert(Hash_Map_##name *map, K key, b32 *is_new);            \
+    static V  *hash_map_##name##_put(Hash_Map_##name *map, K key, V value);                   \
+    static b32 hash_map_##name##_remove(Hash_Map_##name *map, K key)
+
+#define HASH_MAP_DEFINE(name, K, V, hash_func, eq_func)                                       \
+    static Hash_Map_##name                                                                    \
+    hash_map_##name##_alloc(Arena *arena, u64 expected_count) {                               \
+        Hash_Map_##name map = {0};                                                            \
+        map.arena = arena;                                                                    \
+        map.cap = hash_map_cap_from_count(expected_count);                                    \
+        map.ctrl = hash_map_ctrl_alloc(arena, map.cap);                                       \
+        map.slots = push_array(arena, Hash_Map_##name##_Slot, map.cap);                       \
+        return map;                                                                           \
+    }                                                                                         \
+                                                                                              \
+    /* Slot holding key, or -1. */                                                            \
+    static s64                                                                                \
+    hash_map_##name##_find(Hash_Map_##name *map, K key, u64 hash) {                           \
+        u64 group_mask = map->cap / HASH_MAP_GROUP_WIDTH - 1;                                 \
+        u8  tag = (u8)(hash >> 57);                                                           \
+        u64 group = hash & group_mask;                                                        \
+        for (u64 step = 1;; step++) {                                                         \
+            const u8 *ctrl = map->ctrl + group * HASH_MAP_GROUP_WIDTH;                        \
+            for (u32 match = hash_map_group_match(ctrl, tag); match; match &= match - 1) {    \
+                u64 slot = group * HASH_MAP_GROUP_WIDTH + hash_map_lowest_bit(match);         \
+                if (eq_func(map->slots[slot].key, key)) {                                     \
+                    return (s64)slot;                                                         \
+                }                                                                             \
+            }                                                                                 \
+            if (hash_map_group_match_empty(ctrl)) {                                           \
+                return -1;                                                                    \
+            }                                                                                 \
+            group = (group + step) & group_mask;                                              \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    /* First EMPTY or DELETED slot on key's probe sequence. */                                \
+    static u64                                                                                \
+    hash_map_##name##_find_free(Hash_Map_##name *map, u64 hash) {                             \
+        u64 group_mask = map->cap / HASH_MAP_GROUP_WIDTH - 1;                                 \
+        u64 group = hash & group_mask;                                                        \
+        for (u64 step = 1;; step++) {                                                         \
+            u32 match = hash_map_group_match_free(map->ctrl + group * HASH_MAP_GROUP_WIDTH);  \
+            if (match) {                                                                      \
+                return group * HASH_MAP_GROUP_WIDTH + hash_map_lowest_bit(match);             \
+            }                                                                                 \
+            group = (group + step) & group_mask;                                              \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    /* Rebuilds into a fresh table: twice the size, or the same size when                     \
+       it's mostly tombstones. */                                                             \
+    static void                                                                               \
+    hash_map_##name##_rehash(Hash_Map_##name *map) {                                          \
+        b32                     grow = (map->count * 2 >= map->cap * 7 / 8);                  \
+        u64                     new_cap = grow ? map->cap * 2 : map->cap;                     \
+        u8                     *old_ctrl = map->ctrl;                                         \
+        Hash_Map_##name##_Slot *old_slots = map->slots;                                       \
+        u64                     old_cap = map->cap;                                           \
+        map->cap = new_cap;                                                                   \
+        map->ctrl = hash_map_ctrl_alloc(map->arena, new_cap);                                 \
+        map->slots = push_array(map->arena, Hash_Map_##name##_Slot, new_cap);                 \
+        map->used = map->count;                                                               \
+        for (u64 i = 0; i < old_cap; i++) {                                                   \
+            if (old_ctrl[i] < HASH_MAP_CTRL_EMPTY) {                                          \
+                u64 hash = hash_func(old_slots[i].key);                                       \
+                u64 slot = hash_map_##name##_find_free(map, hash);                            \
+                map->ctrl[slot] = (u8)(hash >> 57);                                           \
+                map->slots[slot] = old_slots[i];                                              \
+            }                                                                                 \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static V *                                                                                \
+    hash_map_##name##_get(Hash_Map_##name *map, K key) {                                      \
+        s64 slot = hash_map_##name##_find(map, key, hash_func(key));                          \
+        return slot >= 0 ? &map->slots[slot].value : 0;                                       \
+    }                                                                                         \
+                                                                                              \
+    static V *                                                                                \
+    hash_map_##name##_insert(Hash_Map_##name *map, K key, b32 *is_new) {                      \
+        u64 hash = hash_func(key);                                                            \
+        s64 found = hash_map_##name##_find(map, key, hash);                                   \
+        if (is_new) {                                                                         \
+            *is_new = (found < 0);                                                            \
+        }                                                                                     \
+        if (found >= 0) {                                                                     \
+            return &map->slots[found].value;                                                  \
+        }                                                                                     \
+        if (map->used + 1 > map->cap * 7 / 8) {                                               \
+            hash_map_##name##_rehash(map);                                                    \
+        }                                                                                     \
+        u64 slot = hash_map_##name##_find_free(map, hash);                                    \
+        if (map->ctrl[slot] == HASH_MAP_CTRL_EMPTY) {                                         \
+            map->used += 1;                                                                   \
+        }                                                                                     \
+        map->count += 1;                                                                      \
+        map->ctrl[slot] = (u8)(hash >> 57);                                                   \
+        map->slots[slot].key = key;                                                           \
+        MemoryZeroStruct(&map->slots[slot].value);                                            \
+        return &map->slots[slot].value;                                                       \
+    }                                                                                         \
+                                                                                              \
+    static V *                                                                                \
+    hash_map_##name##_put(Hash_Map_##name *map, K key, V value) {                             \
+        V *result = hash_map_##name##_insert(map, key, 0);                                    \
+        *result = value;                                                                      \
+        return result;                                                                        \
+    }                                                                                         \
+                                                                                              \
+    /* A group that still has an EMPTY byte never sent a probe onward, so                     \
+       its slots can go straight back to EMPTY instead of a tombstone. */                     \
+    static b32                                                                                \
+    hash_map_##name##_remove(Hash_Map_##name *map, K key) {                                   \
+        s64 slot = hash_map_##name##_find(map, key, hash_func(key));                          \
+        if (slot < 0) {                                                                       \
+            return 0;                                                                         \
+        }                                                                                     \
+        const u8 *group = map->ctrl + (slot & ~(s64)(HASH_MAP_GROUP_WIDTH - 1));              \
+        if (hash_map_group_match_empty(group)) {                                              \
+            map->ctrl[slot] = HASH_MAP_CTRL_EMPTY;                                            \
+            map->used -= 1;                                                                   \
+        } else {                                                                              \
+            map->ctrl[slot] = HASH_MAP_CTRL_DELETED;                                          \
+        }                                                                                     \
+        map->count -= 1;                                                                      \
+        return 1;                                                                             \
+    }
+
+#define HASH_MAP_STR_DECLARE(name, V) HASH_MAP_DECLARE(name, String, V)
+#define HASH_MAP_STR_DEFINE(name, V)  HASH_MAP_DEFINE(name, String, V, hash_map_hash_str, hash_map_eq_str)
+
+HASH_MAP_DECLARE(u64, u64, u64);
+HASH_MAP_STR_DECLARE(str_ptr, void *);
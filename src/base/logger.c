@@ -119,6 +119,9 @@ log_init(Arena *arena, String log_file_path) {
     }
 
     g_logger_state = push_array(arena, Logger_State, 1);
+    if (!g_logger_state) {
+        return;
+    }
     MemoryZeroStruct(g_logger_state);
 
     g_logger_state->arena = arena;
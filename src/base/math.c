@@ -25,3 +25,19 @@ intersect_2f32(Rng2_f32 a, Rng2_f32 b) {
     c.p1.y = Min(a.max.y, b.max.y);
     return c;
 }
+
+static Vec3_s32_SoA
+vec3_s32_soa_from_array(Arena *arena, Vec3_s32 *points, u64 count) {
+    Vec3_s32_SoA result = {0};
+    u64 cap = count + VEC3_S32_SOA_PAD;
+    result.x = push_array(arena, s32, cap);
+    result.y = push_array(arena, s32, cap);
+    result.z = push_array(arena, s32, cap);
+    result.count = count;
+    for (u64 i = 0; i < count; i++) {
+        result.x[i] = points[i].x;
+        result.y[i] = points[i].y;
+        result.z[i] = points[i].z;
+    }
+    return result;
+}
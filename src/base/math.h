@@ -56,6 +56,17 @@ typedef union Vec3_s32 {
   };
 } Vec3_s32;
 
+// Structure-of-arrays point set for kernels that stream one axis at a time.
+// Each axis is padded with zeroed slots so a 4-wide load starting at any
+// index below count stays inside the allocation.
+#define VEC3_S32_SOA_PAD 4
+typedef struct Vec3_s32_SoA {
+  s32 *x;
+  s32 *y;
+  s32 *z;
+  u64 count;
+} Vec3_s32_SoA;
+
 typedef union Vec4_f32 {
   struct {
     f32 x, y, z, w;
@@ -191,6 +202,9 @@ static inline Mat4_f32 mat_4x4f32(f32 diagonal) {
 
 static inline Rng2_f32 intersect_2f32(Rng2_f32 a, Rng2_f32 b);
 
+static Vec3_s32_SoA vec3_s32_soa_from_array(Arena *arena, Vec3_s32 *points,
+                                            u64 count);
+
 // Thank you john carmak and quake III
 static inline f32 fast_expf(f32 x) {
   union {
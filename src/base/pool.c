@@ -0,0 +1,164 @@
+#include "pool.h"
+
+static u64
+pool_class_from_size(u64 size) {
+    u64 class_idx = 0;
+    while (((u64)POOL_MIN_SIZE << class_idx) < size) {
+        class_idx += 1;
+    }
+    return class_idx;
+}
+
+static Pool *
+pool_alloc(void) {
+    Arena *arena = arena_alloc(.alignment = POOL_MIN_SIZE);
+    Pool  *pool = push_array(arena, Pool, 1);
+    pool->arena = arena;
+    pool->mutex = mutex_alloc();
+    return pool;
+}
+
+// Not thread-safe: every other thread's cache must be done with the pool.
+// The calling thread's cache just forgets its blocks.
+static void
+pool_release(Pool *pool) {
+    if (!pool)
+        return;
+    TCTX *tctx = tctx_selected();
+    if (tctx && tctx->pool_cache.pool == pool) {
+        MemoryZeroStruct(&tctx->pool_cache);
+    }
+    mutex_release(pool->mutex);
+    arena_release(pool->arena);
+}
+
+// Moves up to `count` blocks of a class from the shared list into `out`,
+// carving new ones from the arena once the list runs dry. Caller holds the
+// mutex.
+static Pool_Block *
+pool_take_locked(Pool *pool, u64 class_idx, u64 count) {
+    u64         block_size = POOL_MIN_SIZE << class_idx;
+    Pool_Block *first = 0;
+    for (u64 i = 0; i < count; i++) {
+        Pool_Block *block = pool->free[class_idx];
+        if (block) {
+            pool->free[class_idx] = block->next;
+            pool->free_count[class_idx] -= 1;
+        } else {
+            block = (Pool_Block *)arena_push(pool->arena, block_size);
+            if (!block) {
+                break;
+            }
+        }
+        block->next = first;
+        first = block;
+    }
+    return first;
+}
+
+// The calling thread's cache, bound to pool, or 0 without a TCTX.
+static Pool_Cache *
+pool_cache_for(Pool *pool) {
+    TCTX *tctx = tctx_selected();
+    if (!tctx) {
+        return 0;
+    }
+    Pool_Cache *cache = &tctx->pool_cache;
+    if (cache->pool != pool) {
+        pool_cache_flush(cache);
+        cache->pool = pool;
+    }
+    return cache;
+}
+
+static void *
+pool_push(Pool *pool, u64 size) {
+    Assert(size <= POOL_MAX_SIZE);
+    u64         class_idx = pool_class_from_size(size);
+    Pool_Block *block = 0;
+    Pool_Cache *cache = pool_cache_for(pool);
+
+    if (cache) {
+        if (!cache->free[class_idx]) {
+            mutex_take(pool->mutex);
+            cache->free[class_idx] = pool_take_locked(pool, class_idx, POOL_CACHE_BATCH);
+            mutex_drop(pool->mutex);
+            for (Pool_Block *b = cache->free[class_idx]; b; b = b->next) {
+                cache->count[class_idx] += 1;
+            }
+        }
+        block = cache->free[class_idx];
+        if (block) {
+            cache->free[class_idx] = block->next;
+            cache->count[class_idx] -= 1;
+        }
+    } else {
+        mutex_take(pool->mutex);
+        block = pool_take_locked(pool, class_idx, 1);
+        mutex_drop(pool->mutex);
+    }
+
+    if (block) {
+        MemoryZero(block, POOL_MIN_SIZE << class_idx);
+    }
+    return block;
+}
+
+// Pushes `count` blocks of a cache's list back to its pool's shared list.
+static void
+pool_give_back(Pool_Cache *cache, u64 class_idx, u64 count) {
+    Pool       *pool = cache->pool;
+    Pool_Block *first = cache->free[class_idx];
+    Pool_Block *last = first;
+    for (u64 i = 1; i < count; i++) {
+        last = last->next;
+    }
+    cache->free[class_idx] = last->next;
+    cache->count[class_idx] -= (u32)count;
+
+    mutex_take(pool->mutex);
+    last->next = pool->free[class_idx];
+    pool->free[class_idx] = first;
+    pool->free_count[class_idx] += count;
+    mutex_drop(pool->mutex);
+}
+
+static void
+pool_free(Pool *pool, void *ptr, u64 size) {
+    if (!ptr)
+        return;
+    Assert(size <= POOL_MAX_SIZE);
+    u64         class_idx = pool_class_from_size(size);
+    Pool_Block *block = (Pool_Block *)ptr;
+    Pool_Cache *cache = pool_cache_for(pool);
+
+    if (cache) {
+        block->next = cache->free[class_idx];
+        cache->free[class_idx] = block;
+        cache->count[class_idx] += 1;
+        // Keep one batch in hand after trimming, so alternating alloc/free
+        // around the limit doesn't hit the mutex every time.
+        if (cache->count[class_idx] >= 2 * POOL_CACHE_BATCH) {
+            pool_give_back(cache, class_idx, POOL_CACHE_BATCH);
+        }
+    } else {
+        mutex_take(pool->mutex);
+        block->next = pool->free[class_idx];
+        pool->free[class_idx] = block;
+        pool->free_count[class_idx] += 1;
+        mutex_drop(pool->mutex);
+    }
+}
+
+// Returns every cached block to the cache's pool and unbinds it.
+static void
+pool_cache_flush(Pool_Cache *cache) {
+    if (!cache->pool)
+        return;
+    for (u64 class_idx = 0; class_idx < POOL_CLASS_COUNT; class_idx++) {
+        if (cache->count[class_idx] != 0) {
+            pool_give_back(cache, class_idx, cache->count[class_idx]);
+        }
+    }
+    cache->pool = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Segregated-fit pool for objects that are freed one at a time. Blocks come
+// in power-of-two size classes from POOL_MIN_SIZE to POOL_MAX_SIZE, carved
+// from one backing Arena per pool; a freed block goes on its class's
+// intrusive free list and is handed out again before the arena grows, so a
+// workload with steady churn keeps a flat footprint.
+//
+// The shared free lists sit behind one mutex. Each TCTX carries a
+// Pool_Cache that keeps a few blocks of each class for its thread, trading
+// whole batches with the shared lists, so most allocs and frees never take
+// the lock. A thread without a TCTX goes straight to the shared lists. The
+// cache serves one pool at a time and flushes to the old one when the
+// thread moves to another; tctx_release flushes it too. Every other thread
+// that used a pool must be done (or have flushed) before pool_release.
+//
+// Frees must pass the size that was allocated (any size in the same class
+// works); blocks carry no header.
+
+#define POOL_MIN_SIZE     16
+#define POOL_CLASS_COUNT  13 // 16 bytes .. 64KB
+#define POOL_MAX_SIZE     (POOL_MIN_SIZE << (POOL_CLASS_COUNT - 1))
+#define POOL_CACHE_BATCH  32 // Blocks moved between a cache and the pool at once
+
+typedef struct Pool_Block Pool_Block;
+struct Pool_Block {
+    Pool_Block *next;
+};
+
+typedef struct Pool Pool;
+struct Pool {
+    Arena      *arena;
+    Mutex       mutex;
+    Pool_Block *free[POOL_CLASS_COUNT];
+    u64         free_count[POOL_CLASS_COUNT];
+};
+
+typedef struct Pool_Cache Pool_Cache;
+struct Pool_Cache {
+    Pool       *pool; // Owner of the cached blocks
+    Pool_Block *free[POOL_CLASS_COUNT];
+    u32         count[POOL_CLASS_COUNT];
+};
+
+static Pool *pool_alloc(void);
+static void  pool_release(Pool *pool);
+static void *pool_push(Pool *pool, u64 size);
+static void  pool_free(Pool *pool, void *ptr, u64 size);
+static void  pool_cache_flush(Pool_Cache *cache);
+
+#define pool_push_array(p, T, n)    (T *)pool_push((p), sizeof(T) * (n))
+#define pool_free_array(p, ptr, n) pool_free((p), (ptr), sizeof(*(ptr)) * (n))
@@ -152,3 +152,22 @@ struct Simd_V4u32 { u32 v[4]; };
 // SHUFFLE
 // simd_shuffle_u8(a, idx)    - Shuffle bytes using index vector. Index 0x80+ -> 0
 //                              @example shuffle({a,b,c,d},{3,2,1,0}) -> {d,c,b,a}
+//
+// GEOMETRY
+// simd_dist_sq_s32(x,y,z,p,out) - Squared distance from p to the 4 points at
+//                              x[0..3], y[0..3], z[0..3], written to out[0..3]
+//                              as u64. Per-axis differences must fit in s32:
+//                              every backend squares the low 32 bits of each
+//                              difference, and debug builds assert the fit.
+//                              @example x={0,1,2,3},y=z={0,..},p=(1,0,0) -> {1,0,1,4}
+
+#if DEBUG_MODE
+#define simd_assert_dist_s32(x, y, z, p)                                   \
+    Stmnt(for (u32 i_ = 0; i_ < 4; i_++) {                                 \
+        Assert((s64)(x)[i_] - (p).x == (s32)((s64)(x)[i_] - (p).x));       \
+        Assert((s64)(y)[i_] - (p).y == (s32)((s64)(y)[i_] - (p).y));       \
+        Assert((s64)(z)[i_] - (p).z == (s32)((s64)(z)[i_] - (p).z));       \
+    })
+#else
+#define simd_assert_dist_s32(x, y, z, p)
+#endif
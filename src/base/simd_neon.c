@@ -396,4 +396,20 @@ simd_shuffle_u8(Simd_V16u8 a, Simd_V16u8 indices) {
     return (Simd_V16u8){vqtbl1q_u8(a.v, indices.v)};
 }
 
+static void
+simd_dist_sq_s32(const s32 *x, const s32 *y, const s32 *z, Vec3_s32 p, u64 *out) {
+    simd_assert_dist_s32(x, y, z, p);
+    int32x4_t dx = vsubq_s32(vld1q_s32(x), vdupq_n_s32(p.x));
+    int32x4_t dy = vsubq_s32(vld1q_s32(y), vdupq_n_s32(p.y));
+    int32x4_t dz = vsubq_s32(vld1q_s32(z), vdupq_n_s32(p.z));
+    int64x2_t lo = vmull_s32(vget_low_s32(dx), vget_low_s32(dx));
+    lo = vmlal_s32(lo, vget_low_s32(dy), vget_low_s32(dy));
+    lo = vmlal_s32(lo, vget_low_s32(dz), vget_low_s32(dz));
+    int64x2_t hi = vmull_high_s32(dx, dx);
+    hi = vmlal_high_s32(hi, dy, dy);
+    hi = vmlal_high_s32(hi, dz, dz);
+    vst1q_u64(out, vreinterpretq_u64_s64(lo));
+    vst1q_u64(out + 2, vreinterpretq_u64_s64(hi));
+}
+
 #endif
@@ -542,4 +542,16 @@ simd_shuffle_u8(Simd_V16u8 a, Simd_V16u8 indices) {
     return r;
 }
 
+static void
+simd_dist_sq_s32(const s32 *x, const s32 *y, const s32 *z, Vec3_s32 p, u64 *out) {
+    simd_assert_dist_s32(x, y, z, p);
+    for (u32 i = 0; i < 4; i++) {
+        // Wraps like the vector backends' 32-bit lanes.
+        s64 dx = (s32)((u32)x[i] - (u32)p.x);
+        s64 dy = (s32)((u32)y[i] - (u32)p.y);
+        s64 dz = (s32)((u32)z[i] - (u32)p.z);
+        out[i] = (u64)(dx * dx) + (u64)(dy * dy) + (u64)(dz * dz);
+    }
+}
+
 #endif
@@ -419,4 +419,38 @@ simd_shuffle_u8(Simd_V16u8 a, Simd_V16u8 indices) {
     return (Simd_V16u8){_mm_shuffle_epi8(a.v, indices.v)};
 }
 
+#if USE_AVX2
+// Differences in 32 bits, widened for _mm256_mul_epi32, which squares the
+// low s32 of each 64-bit lane.
+static void
+simd_dist_sq_s32(const s32 *x, const s32 *y, const s32 *z, Vec3_s32 p, u64 *out) {
+    simd_assert_dist_s32(x, y, z, p);
+    __m256i dx = _mm256_cvtepi32_epi64(_mm_sub_epi32(_mm_loadu_si128((const __m128i*)x), _mm_set1_epi32(p.x)));
+    __m256i dy = _mm256_cvtepi32_epi64(_mm_sub_epi32(_mm_loadu_si128((const __m128i*)y), _mm_set1_epi32(p.y)));
+    __m256i dz = _mm256_cvtepi32_epi64(_mm_sub_epi32(_mm_loadu_si128((const __m128i*)z), _mm_set1_epi32(p.z)));
+    __m256i sum = _mm256_add_epi64(_mm256_mul_epi32(dx, dx), _mm256_mul_epi32(dy, dy));
+    sum = _mm256_add_epi64(sum, _mm256_mul_epi32(dz, dz));
+    _mm256_storeu_si256((__m256i*)out, sum);
+}
+#else
+// _mm_mul_epi32 only reads the even s32 lanes, so the odd lanes are shifted
+// down and multiplied separately, then interleaved back into order.
+static void
+simd_dist_sq_s32(const s32 *x, const s32 *y, const s32 *z, Vec3_s32 p, u64 *out) {
+    simd_assert_dist_s32(x, y, z, p);
+    __m128i dx = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)x), _mm_set1_epi32(p.x));
+    __m128i dy = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)y), _mm_set1_epi32(p.y));
+    __m128i dz = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)z), _mm_set1_epi32(p.z));
+    __m128i even = _mm_add_epi64(_mm_mul_epi32(dx, dx), _mm_mul_epi32(dy, dy));
+    even = _mm_add_epi64(even, _mm_mul_epi32(dz, dz));
+    dx = _mm_srli_epi64(dx, 32);
+    dy = _mm_srli_epi64(dy, 32);
+    dz = _mm_srli_epi64(dz, 32);
+    __m128i odd = _mm_add_epi64(_mm_mul_epi32(dx, dx), _mm_mul_epi32(dy, dy));
+    odd = _mm_add_epi64(odd, _mm_mul_epi32(dz, dz));
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi64(even, odd));
+    _mm_storeu_si128((__m128i*)(out + 2), _mm_unpackhi_epi64(even, odd));
+}
+#endif
+
 #endif
@@ -1,42 +1,172 @@
 #include "sort.h"
 
-#define RADIX_BITS     8
-#define RADIX_BUCKETS  (1 << RADIX_BITS)
-#define RADIX_MASK     (RADIX_BUCKETS - 1)
-#define RADIX_PASSES   (64 / RADIX_BITS)
+#define radix_key_self(e)     (*(e))
+#define radix_less_self(a, b) ((a) < (b))
+#define radix_less_pair(a, b) ((a).key < (b).key)
+
+RADIX_SORT_DEFINE(array_u64, u64, u64, radix_key_self)
+RADIX_SORT_DEFINE(array_u32, u32, u32, radix_key_self)
+RADIX_SORT_DEFINE_MEMBER(pair_u64, Sort_Pair_u64, u64, key)
+
+RADIX_SORT_IN_PLACE_DEFINE(array_u64, u64, u64, radix_key_self, radix_less_self)
+RADIX_SORT_IN_PLACE_DEFINE(array_u32, u32, u32, radix_key_self, radix_less_self)
+RADIX_SORT_IN_PLACE_DEFINE(pair_u64, Sort_Pair_u64, u64, radix_key_pair_u64, radix_less_pair)
+
+static Radix_Plan
+radix_plan_from_digits(u64 diff_mask, u32 digit_bits) {
+    Radix_Plan plan = {0};
+    plan.digit_bits = digit_bits;
+    if (diff_mask == 0) {
+        return plan;
+    }
+    u64 digit_mask = (1ull << digit_bits) - 1;
+    for (u32 shift = (u32)__builtin_ctzll(diff_mask); shift < 64; shift += digit_bits) {
+        if ((diff_mask >> shift) & digit_mask) {
+            plan.shift[plan.pass_count++] = shift;
+        }
+    }
+    return plan;
+}
+
+static Radix_Plan
+radix_plan_from_mask(u64 diff_mask) {
+    // Ties go to the narrow digits, whose histograms stay in L1.
+    Radix_Plan narrow = radix_plan_from_digits(diff_mask, RADIX_BITS);
+    Radix_Plan wide = radix_plan_from_digits(diff_mask, RADIX_WIDE_BITS);
+    return wide.pass_count < narrow.pass_count ? wide : narrow;
+}
+
+static void
+radix_flag_bounds(u64 *counts, u64 *heads, u64 *tails) {
+    u64 offset = 0;
+    for (u64 b = 0; b < RADIX_FLAG_BUCKETS; b++) {
+        heads[b] = offset;
+        offset += counts[b];
+        tails[b] = offset;
+    }
+}
+
+static void
+radix_prefix(u64 *histogram, u64 bucket_count) {
+    u64 offset = 0;
+    for (u64 b = 0; b < bucket_count; b++) {
+        u64 c = histogram[b];
+        histogram[b] = offset;
+        offset += c;
+    }
+}
+
+static u64
+radix_lane_diff_mask(u64 *lane_histograms, u64 key_or, u64 key_and) {
+    u64 *slot = lane_histograms + lane_idx() * RADIX_MAX_BUCKETS;
+    slot[0] = key_or;
+    slot[1] = key_and;
+    lane_sync();
+
+    key_or = 0;
+    key_and = MAX_U64;
+    for (u64 lane = 0; lane < lane_count(); lane++) {
+        key_or |= lane_histograms[lane * RADIX_MAX_BUCKETS + 0];
+        key_and &= lane_histograms[lane * RADIX_MAX_BUCKETS + 1];
+    }
+    lane_sync();
+    return key_or ^ key_and;
+}
+
+static Radix_WC
+radix_wc_alloc(Arena *arena, u64 bucket_count) {
+    Radix_WC wc = {0};
+    u8 *stage = push_array_no_zero(arena, u8, bucket_count * RADIX_WC_LINE + RADIX_WC_LINE);
+    wc.stage = (u8 *)PtrFromInt(AlignUpPow2(IntFromPtr(stage), RADIX_WC_LINE));
+    wc.fill = push_array(arena, u8, bucket_count);
+    wc.limit = push_array(arena, u8, bucket_count);
+    return wc;
+}
+
+static u8
+radix_wc_limit(void *dst, u64 element_size) {
+    u64 room = RADIX_WC_LINE - (IntFromPtr(dst) & (RADIX_WC_LINE - 1));
+    u64 limit = room / element_size;
+    // Destinations that are not element aligned never land on a boundary;
+    // those just flush whole lines' worth.
+    return (u8)(limit ? limit : RADIX_WC_LINE / element_size);
+}
+
+static void
+radix_wc_flush(void *dst, void *src, u64 size) {
+#if RADIX_STREAM_STORES && (USE_SSE4 || USE_AVX2)
+    if (size == RADIX_WC_LINE && (IntFromPtr(dst) & (RADIX_WC_LINE - 1)) == 0) {
+        __m128i *d = (__m128i *)dst;
+        __m128i *s = (__m128i *)src;
+        _mm_stream_si128(d + 0, _mm_load_si128(s + 0));
+        _mm_stream_si128(d + 1, _mm_load_si128(s + 1));
+        _mm_stream_si128(d + 2, _mm_load_si128(s + 2));
+        _mm_stream_si128(d + 3, _mm_load_si128(s + 3));
+        return;
+    }
+#endif
+    MemoryCopy(dst, src, size);
+}
+
+static void
+radix_wc_fence(void) {
+#if RADIX_STREAM_STORES && (USE_SSE4 || USE_AVX2)
+    _mm_sfence();
+#endif
+}
+
+static void
+radix_lane_prefix(u64 *lane_histograms, u64 *global_histogram, u64 bucket_count) {
+    u64 num_lanes = lane_count();
+    Rng1U64 buckets = lane_range(bucket_count);
+    for (u64 b = buckets.min; b < buckets.max; b++) {
+        u64 total = 0;
+        for (u64 lane = 0; lane < num_lanes; lane++) {
+            u64 c = lane_histograms[lane * bucket_count + b];
+            lane_histograms[lane * bucket_count + b] = total;
+            total += c;
+        }
+        global_histogram[b] = total;
+    }
+    lane_scan_u64(global_histogram, bucket_count);
+}
 
 void
 radix_sort_u64(void *elements, u64 count, u64 element_size, Sort_Key_Func get_key, Arena *arena) {
     if (count <= 1) return;
 
     u8 *src = (u8 *)elements;
-    u8 *dst = push_array(arena, u8, count * element_size);
-    u64 histogram[RADIX_BUCKETS];
-
-    for (u32 pass = 0; pass < RADIX_PASSES; pass++) {
-        u32 shift = pass * RADIX_BITS;
+    u64 key_or = 0, key_and = MAX_U64;
+    for (u64 i = 0; i < count; i++) {
+        u64 key = get_key(src + i * element_size);
+        key_or |= key;
+        key_and &= key;
+    }
 
-        for (u64 i = 0; i < RADIX_BUCKETS; i++) {
-            histogram[i] = 0;
-        }
+    Radix_Plan plan = radix_plan_from_mask(key_or ^ key_and);
+    if (plan.pass_count == 0) return;
 
-        for (u64 i = 0; i < count; i++) {
-            u64 key = get_key(src + i * element_size);
-            u64 bucket = (key >> shift) & RADIX_MASK;
-            histogram[bucket]++;
+    // Every digit's histogram comes out of the same read pass.
+    u64 bucket_count = 1ull << plan.digit_bits;
+    u64 digit_mask = bucket_count - 1;
+    u64 *histograms = push_array(arena, u64, plan.pass_count * bucket_count);
+    for (u64 i = 0; i < count; i++) {
+        u64 key = get_key(src + i * element_size);
+        for (u32 p = 0; p < plan.pass_count; p++) {
+            histograms[p * bucket_count + ((key >> plan.shift[p]) & digit_mask)]++;
         }
+    }
 
-        u64 offset = 0;
-        for (u64 i = 0; i < RADIX_BUCKETS; i++) {
-            u64 c = histogram[i];
-            histogram[i] = offset;
-            offset += c;
-        }
+    u8 *dst = push_array(arena, u8, count * element_size);
+    for (u32 p = 0; p < plan.pass_count; p++) {
+        u64 *histogram = histograms + p * bucket_count;
+        u32 shift = plan.shift[p];
+        radix_prefix(histogram, bucket_count);
 
         for (u64 i = 0; i < count; i++) {
             void *elem = src + i * element_size;
             u64 key = get_key(elem);
-            u64 bucket = (key >> shift) & RADIX_MASK;
+            u64 bucket = (key >> shift) & digit_mask;
             u64 dst_idx = histogram[bucket]++;
             MemoryCopy(dst + dst_idx * element_size, elem, element_size);
         }
@@ -53,62 +183,88 @@ radix_sort_u64(void *elements, u64 count, u64 element_size, Sort_Key_Func get_ke
 
 void
 radix_sort_u64_lane(void *elements, u64 count, u64 element_size, Sort_Key_Func get_key,
-                    void *temp_buffer, u64 *lane_histograms, u64 *global_histogram) {
+                    void *temp_buffer, u64 *lane_histograms, u64 *global_histogram,
+                    RadixFlags flags) {
     if (count <= 1) return;
 
     u64 my_lane = lane_idx();
-    u64 num_lanes = lane_count();
-    u64 *my_histogram = lane_histograms + my_lane * RADIX_BUCKETS;
-
     u8 *src = (u8 *)elements;
     u8 *dst = (u8 *)temp_buffer;
 
     Rng1U64 my_range = lane_range(count);
 
-    for (u32 pass = 0; pass < RADIX_PASSES; pass++) {
-        u32 shift = pass * RADIX_BITS;
+    u64 key_or = 0, key_and = MAX_U64;
+    for (u64 i = my_range.min; i < my_range.max; i++) {
+        u64 key = get_key(src + i * element_size);
+        key_or |= key;
+        key_and &= key;
+    }
+    Radix_Plan plan = radix_plan_from_mask(radix_lane_diff_mask(lane_histograms, key_or, key_and));
+
+    u64 bucket_count = 1ull << plan.digit_bits;
+    u64 digit_mask = bucket_count - 1;
+    u64 *my_histogram = lane_histograms + my_lane * bucket_count;
 
-        for (u64 i = 0; i < RADIX_BUCKETS; i++) {
+    Scratch scratch = scratch_begin(0, 0);
+    b32 use_wc = RADIX_WC_USABLE(flags, element_size, count);
+    Radix_WC wc = use_wc ? radix_wc_alloc(scratch.arena, bucket_count) : (Radix_WC){0};
+
+    for (u32 pass = 0; pass < plan.pass_count; pass++) {
+        u32 shift = plan.shift[pass];
+
+        for (u64 i = 0; i < bucket_count; i++) {
             my_histogram[i] = 0;
         }
 
         for (u64 i = my_range.min; i < my_range.max; i++) {
             u64 key = get_key(src + i * element_size);
-            u64 bucket = (key >> shift) & RADIX_MASK;
+            u64 bucket = (key >> shift) & digit_mask;
             my_histogram[bucket]++;
         }
 
         lane_sync();
 
-        if (my_lane == 0) {
-            for (u64 b = 0; b < RADIX_BUCKETS; b++) {
-                u64 total = 0;
-                for (u64 lane = 0; lane < num_lanes; lane++) {
-                    u64 c = lane_histograms[lane * RADIX_BUCKETS + b];
-                    lane_histograms[lane * RADIX_BUCKETS + b] = total;
-                    total += c;
-                }
-                global_histogram[b] = total;
-            }
+        radix_lane_prefix(lane_histograms, global_histogram, bucket_count);
 
-            u64 offset = 0;
-            for (u64 b = 0; b < RADIX_BUCKETS; b++) {
-                u64 c = global_histogram[b];
-                global_histogram[b] = offset;
-                offset += c;
-            }
+        for (u64 b = 0; b < bucket_count; b++) {
+            my_histogram[b] += global_histogram[b];
         }
 
-        lane_sync();
+        if (use_wc) {
+            for (u64 b = 0; b < bucket_count; b++) {
+                wc.fill[b] = 0;
+                wc.limit[b] = radix_wc_limit(dst + my_histogram[b] * element_size, element_size);
+            }
 
-        for (u64 i = my_range.min; i < my_range.max; i++) {
-            void *elem = src + i * element_size;
-            u64 key = get_key(elem);
-            u64 bucket = (key >> shift) & RADIX_MASK;
-            u64 global_offset = global_histogram[bucket];
-            u64 lane_offset = my_histogram[bucket]++;
-            u64 dst_idx = global_offset + lane_offset;
-            MemoryCopy(dst + dst_idx * element_size, elem, element_size);
+            for (u64 i = my_range.min; i < my_range.max; i++) {
+                void *elem = src + i * element_size;
+                u64 key = get_key(elem);
+                u64 bucket = (key >> shift) & digit_mask;
+                u8 *line = wc.stage + bucket * RADIX_WC_LINE;
+                MemoryCopy(line + wc.fill[bucket] * element_size, elem, element_size);
+                wc.fill[bucket]++;
+                if (wc.fill[bucket] == wc.limit[bucket]) {
+                    u8 *out = dst + my_histogram[bucket] * element_size;
+                    radix_wc_flush(out, line, wc.fill[bucket] * element_size);
+                    my_histogram[bucket] += wc.fill[bucket];
+                    wc.fill[bucket] = 0;
+                    wc.limit[bucket] = radix_wc_limit(dst + my_histogram[bucket] * element_size, element_size);
+                }
+            }
+
+            for (u64 b = 0; b < bucket_count; b++) {
+                radix_wc_flush(dst + my_histogram[b] * element_size, wc.stage + b * RADIX_WC_LINE,
+                               wc.fill[b] * element_size);
+            }
+            radix_wc_fence();
+        } else {
+            for (u64 i = my_range.min; i < my_range.max; i++) {
+                void *elem = src + i * element_size;
+                u64 key = get_key(elem);
+                u64 bucket = (key >> shift) & digit_mask;
+                u64 dst_idx = my_histogram[bucket]++;
+                MemoryCopy(dst + dst_idx * element_size, elem, element_size);
+            }
         }
 
         lane_sync();
@@ -118,6 +274,7 @@ radix_sort_u64_lane(void *elements, u64 count, u64 element_size, Sort_Key_Func g
         dst = tmp;
     }
 
+    scratch_end(scratch);
     lane_sync();
     if (my_lane == 0 && src != (u8 *)elements) {
         MemoryCopy(elements, src, count * element_size);
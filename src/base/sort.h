@@ -1,8 +1,425 @@
 #pragma once
 
+// Digits are RADIX_BITS or RADIX_WIDE_BITS wide, whichever needs fewer passes
+// over the bits that actually vary between keys. Digits where every key
+// agrees are skipped outright.
+#define RADIX_BITS          8
+#define RADIX_WIDE_BITS     11
+#define RADIX_MAX_BUCKETS   (1 << RADIX_WIDE_BITS)
+#define RADIX_MAX_PASSES    (64 / RADIX_BITS)
+
+// In-place MSD sorts always use narrow digits, and finish buckets at or
+// below this size with insertion sort. Larger runs of equal keys are sorted
+// again on a tie key when the instance has one.
+#define RADIX_FLAG_BUCKETS     (1 << RADIX_BITS)
+#define RADIX_INSERTION_COUNT  32
+
+// Write-combining mode: large lane sorts stage each bucket's elements in a
+// cache-line buffer and write them out a line at a time, instead of
+// scattering every element to a random destination. Full aligned lines use
+// streaming stores where the target has them. Only used when the caller
+// passes RadixFlag_WriteCombine; it pays off once the destination array is
+// well past the last-level cache (day 8: -lsd -write-combine).
+typedef enum RadixFlags {
+    RadixFlag_WriteCombine = (1 << 0), // Stage the lane scatter in cache lines
+} RadixFlags;
+
+#ifndef RADIX_STREAM_STORES
+#    define RADIX_STREAM_STORES 1
+#endif
+#define RADIX_WC_LINE      64
+#define RADIX_WC_MIN_COUNT (1 << 16)
+#define RADIX_WC_USABLE(flags, element_size, count)                                    \
+    (((flags) & RadixFlag_WriteCombine) && (count) >= RADIX_WC_MIN_COUNT &&            \
+     (element_size) <= RADIX_WC_LINE / 2)
+
+// Sizes of the shared buffers the lane sorts take.
+#define RADIX_LANE_HISTOGRAM_COUNT(lanes) ((lanes) * RADIX_MAX_BUCKETS)
+#define RADIX_GLOBAL_HISTOGRAM_COUNT      RADIX_MAX_BUCKETS
+
 typedef u64 (*Sort_Key_Func)(void *element);
 
+typedef struct Sort_Pair_u64 {
+    u64 key;
+    u64 value;
+} Sort_Pair_u64;
+
+typedef struct Radix_Plan {
+    u32 digit_bits;
+    u32 pass_count;
+    u32 shift[RADIX_MAX_PASSES];
+} Radix_Plan;
+
 void radix_sort_u64(void *elements, u64 count, u64 element_size, Sort_Key_Func get_key, Arena *arena);
 
 void radix_sort_u64_lane(void *elements, u64 count, u64 element_size, Sort_Key_Func get_key,
-                         void *temp_buffer, u64 *lane_histograms, u64 *global_histogram);
+                         void *temp_buffer, u64 *lane_histograms, u64 *global_histogram,
+                         RadixFlags flags);
+
+// diff_mask has a bit set wherever at least two keys differ.
+static Radix_Plan radix_plan_from_mask(u64 diff_mask);
+static Radix_Plan radix_plan_from_digits(u64 diff_mask, u32 digit_bits);
+
+// Turns bucket counts into [heads[b], tails[b]) ranges for the in-place sorts.
+static void radix_flag_bounds(u64 *counts, u64 *heads, u64 *tails);
+
+// Exclusive prefix sum over one histogram, in place.
+static void radix_prefix(u64 *histogram, u64 bucket_count);
+
+// Combines each lane's OR and AND of its keys into the diff mask for the
+// whole array. Borrows the lane histograms as exchange slots.
+static u64 radix_lane_diff_mask(u64 *lane_histograms, u64 key_or, u64 key_and);
+
+// Per-lane staging for the write-combining scatter, from the lane's scratch.
+typedef struct Radix_WC Radix_WC;
+struct Radix_WC {
+    u8 *stage; // RADIX_WC_LINE bytes per bucket, line aligned
+    u8 *fill;  // Elements staged per bucket
+    u8 *limit; // Elements that take the bucket to its next line boundary
+};
+
+static Radix_WC radix_wc_alloc(Arena *arena, u64 bucket_count);
+// How many elements fit between dst and the next line boundary.
+static u8       radix_wc_limit(void *dst, u64 element_size);
+static void     radix_wc_flush(void *dst, void *src, u64 size);
+static void     radix_wc_fence(void);
+
+// Turns per-lane bucket counts into each lane's offset within its bucket,
+// and global_histogram into bucket start offsets. Every lane must call it;
+// each lane merges a slice of the buckets, then lane_scan_u64 places them.
+static void radix_lane_prefix(u64 *lane_histograms, u64 *global_histogram, u64 bucket_count);
+
+// Typed LSD radix sorts. key_func takes a `const T *` and returns the key as
+// type K, so it inlines into the passes and elements move as whole structs.
+// The serial sort counts every digit in a single read pass; the lane sort has
+// to recount per pass since each lane's offsets depend on where its elements
+// landed in the previous one.
+//
+//   radix_sort_<name>(T *elements, u64 count, Arena *arena)
+//   radix_sort_<name>_lane(T *elements, u64 count, T *temp_buffer,
+//                          u64 *lane_histograms, u64 *global_histogram,
+//                          RadixFlags flags)
+#define RADIX_SORT_DEFINE(name, T, K, key_func)                                               \
+    static void                                                                               \
+    radix_sort_##name(T *elements, u64 count, Arena *arena) {                                 \
+        if (count <= 1) return;                                                               \
+        u64 key_or = 0, key_and = MAX_U64;                                                    \
+        for (u64 i = 0; i < count; i++) {                                                     \
+            u64 key = (u64)key_func(&elements[i]);                                            \
+            key_or |= key;                                                                    \
+            key_and &= key;                                                                   \
+        }                                                                                     \
+        Radix_Plan plan = radix_plan_from_mask(key_or ^ key_and);                             \
+        if (plan.pass_count == 0) return;                                                     \
+        u64 bucket_count = 1ull << plan.digit_bits;                                           \
+        u64 digit_mask = bucket_count - 1;                                                    \
+        u64 *histograms = push_array(arena, u64, plan.pass_count * bucket_count);             \
+        for (u64 i = 0; i < count; i++) {                                                     \
+            u64 key = (u64)key_func(&elements[i]);                                            \
+            for (u32 p = 0; p < plan.pass_count; p++) {                                       \
+                histograms[p * bucket_count + ((key >> plan.shift[p]) & digit_mask)]++;       \
+            }                                                                                 \
+        }                                                                                     \
+        T *src = elements;                                                                    \
+        T *dst = push_array_no_zero(arena, T, count);                                         \
+        for (u32 p = 0; p < plan.pass_count; p++) {                                           \
+            u64 *histogram = histograms + p * bucket_count;                                   \
+            u32 shift = plan.shift[p];                                                        \
+            radix_prefix(histogram, bucket_count);                                            \
+            for (u64 i = 0; i < count; i++) {                                                 \
+                dst[histogram[((u64)key_func(&src[i]) >> shift) & digit_mask]++] = src[i];    \
+            }                                                                                 \
+            T *tmp = src;                                                                     \
+            src = dst;                                                                        \
+            dst = tmp;                                                                        \
+        }                                                                                     \
+        if (src != elements) {                                                                \
+            MemoryCopy(elements, src, count * sizeof(T));                                     \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static void                                                                               \
+    radix_sort_##name##_lane(T *elements, u64 count, T *temp_buffer,                          \
+                             u64 *lane_histograms, u64 *global_histogram,                     \
+                             RadixFlags flags) {                                              \
+        if (count <= 1) return;                                                               \
+        Rng1U64 my_range = lane_range(count);                                                 \
+        u64 key_or = 0, key_and = MAX_U64;                                                    \
+        for (u64 i = my_range.min; i < my_range.max; i++) {                                   \
+            u64 key = (u64)key_func(&elements[i]);                                            \
+            key_or |= key;                                                                    \
+            key_and &= key;                                                                   \
+        }                                                                                     \
+        Radix_Plan plan = radix_plan_from_mask(                                               \
+            radix_lane_diff_mask(lane_histograms, key_or, key_and));                          \
+        u64 bucket_count = 1ull << plan.digit_bits;                                           \
+        u64 digit_mask = bucket_count - 1;                                                    \
+        u64 *my_histogram = lane_histograms + lane_idx() * bucket_count;                      \
+        T *src = elements;                                                                    \
+        T *dst = temp_buffer;                                                                 \
+        Scratch scratch = scratch_begin(0, 0);                                                \
+        b32 use_wc = RADIX_WC_USABLE(flags, sizeof(T), count);                                \
+        Radix_WC wc = use_wc ? radix_wc_alloc(scratch.arena, bucket_count) : (Radix_WC){0};   \
+        for (u32 p = 0; p < plan.pass_count; p++) {                                           \
+            u32 shift = plan.shift[p];                                                        \
+            MemoryZero(my_histogram, bucket_count * sizeof(u64));                             \
+            for (u64 i = my_range.min; i < my_range.max; i++) {                               \
+                my_histogram[((u64)key_func(&src[i]) >> shift) & digit_mask]++;               \
+            }                                                                                 \
+            lane_sync();                                                                      \
+            radix_lane_prefix(lane_histograms, global_histogram, bucket_count);               \
+            for (u64 b = 0; b < bucket_count; b++) {                                          \
+                my_histogram[b] += global_histogram[b];                                       \
+            }                                                                                 \
+            if (use_wc) {                                                                     \
+                for (u64 b = 0; b < bucket_count; b++) {                                      \
+                    wc.fill[b] = 0;                                                           \
+                    wc.limit[b] = radix_wc_limit(dst + my_histogram[b], sizeof(T));           \
+                }                                                                             \
+                for (u64 i = my_range.min; i < my_range.max; i++) {                           \
+                    u64 bucket = ((u64)key_func(&src[i]) >> shift) & digit_mask;              \
+                    T *line = (T *)(wc.stage + bucket * RADIX_WC_LINE);                       \
+                    line[wc.fill[bucket]++] = src[i];                                         \
+                    if (wc.fill[bucket] == wc.limit[bucket]) {                                \
+                        radix_wc_flush(dst + my_histogram[bucket], line,                      \
+                                       wc.fill[bucket] * sizeof(T));                          \
+                        my_histogram[bucket] += wc.fill[bucket];                              \
+                        wc.fill[bucket] = 0;                                                  \
+                        wc.limit[bucket] = radix_wc_limit(dst + my_histogram[bucket], sizeof(T)); \
+                    }                                                                         \
+                }                                                                             \
+                for (u64 b = 0; b < bucket_count; b++) {                                      \
+                    radix_wc_flush(dst + my_histogram[b], wc.stage + b * RADIX_WC_LINE,       \
+                                   wc.fill[b] * sizeof(T));                                   \
+                }                                                                             \
+                radix_wc_fence();                                                             \
+            } else {                                                                          \
+                for (u64 i = my_range.min; i < my_range.max; i++) {                           \
+                    u64 bucket = ((u64)key_func(&src[i]) >> shift) & digit_mask;              \
+                    dst[my_histogram[bucket]++] = src[i];                                     \
+                }                                                                             \
+            }                                                                                 \
+            lane_sync();                                                                      \
+            T *tmp = src;                                                                     \
+            src = dst;                                                                        \
+            dst = tmp;                                                                        \
+        }                                                                                     \
+        scratch_end(scratch);                                                                 \
+        if (lane_idx() == 0 && src != elements) {                                             \
+            MemoryCopy(elements, src, count * sizeof(T));                                     \
+        }                                                                                     \
+        lane_sync();                                                                          \
+    }
+
+// Key+payload structs: sorts T by its `member` field of type K.
+#define RADIX_SORT_DEFINE_MEMBER(name, T, K, member)                                          \
+    static inline K radix_key_##name(const T *e) { return e->member; }                        \
+    RADIX_SORT_DEFINE(name, T, K, radix_key_##name)
+
+// In-place MSD (American flag) radix sorts: no second buffer, O(1) extra
+// memory beyond a few small histograms per recursion level. Not stable.
+// Buckets that shrink to RADIX_INSERTION_COUNT are finished by insertion
+// sort with less_func(T a, T b), which must agree with the key order.
+// Larger runs of equal keys are radix sorted again on tie_key_func, so a
+// tie-breaking order costs no more than the key itself; runs equal on both
+// keys fall back to heapsort. RADIX_SORT_IN_PLACE_DEFINE has no tie key.
+//
+//   radix_sort_<name>_in_place(T *elements, u64 count)
+//   radix_sort_<name>_in_place_lane(T *elements, u64 count,
+//                                   u64 *lane_histograms, u64 *global_histogram)
+//
+// The lane version counts the top digit across lanes, lane 0 permutes the
+// top level, and then each lane recurses into the buckets that start in its
+// lane_range.
+#define RADIX_SORT_IN_PLACE_DEFINE(name, T, K, key_func, less_func)                           \
+    RADIX_SORT_IN_PLACE_TIE_DEFINE(name, T, K, key_func, radix_tie_key_none, less_func)
+
+#define radix_tie_key_none(e) 0
+
+// One set of MSD levels sorting by key_func. Runs the digits can't split go
+// to `insertion` when small, and to `exhausted` otherwise.
+#define RADIX_FLAG_LEVELS_(name, T, key_func, insertion, exhausted)                           \
+    static void                                                                               \
+    radix_flag_permute_##name(T *v, u32 shift, u64 *heads, u64 *tails) {                      \
+        for (u64 b = 0; b < RADIX_FLAG_BUCKETS; b++) {                                        \
+            while (heads[b] < tails[b]) {                                                     \
+                T e = v[heads[b]];                                                            \
+                u64 d = ((u64)key_func(&e) >> shift) & (RADIX_FLAG_BUCKETS - 1);              \
+                while (d != b) {                                                              \
+                    T displaced = v[heads[d]];                                                \
+                    v[heads[d]++] = e;                                                        \
+                    e = displaced;                                                            \
+                    d = ((u64)key_func(&e) >> shift) & (RADIX_FLAG_BUCKETS - 1);              \
+                }                                                                             \
+                v[heads[b]++] = e;                                                            \
+            }                                                                                 \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static void                                                                               \
+    radix_flag_##name(T *v, u64 count, Radix_Plan *plan, u32 level) {                         \
+        for (; level < plan->pass_count; level++) {                                           \
+            if (count <= RADIX_INSERTION_COUNT) break;                                        \
+            u32 shift = plan->shift[plan->pass_count - 1 - level];                            \
+            u64 counts[RADIX_FLAG_BUCKETS] = {0};                                             \
+            for (u64 i = 0; i < count; i++) {                                                 \
+                counts[((u64)key_func(&v[i]) >> shift) & (RADIX_FLAG_BUCKETS - 1)]++;         \
+            }                                                                                 \
+            if (counts[((u64)key_func(&v[0]) >> shift) & (RADIX_FLAG_BUCKETS - 1)] == count) { \
+                continue;                                                                     \
+            }                                                                                 \
+            u64 heads[RADIX_FLAG_BUCKETS], tails[RADIX_FLAG_BUCKETS];                         \
+            radix_flag_bounds(counts, heads, tails);                                          \
+            radix_flag_permute_##name(v, shift, heads, tails);                                \
+            u64 start = 0;                                                                    \
+            for (u64 b = 0; b < RADIX_FLAG_BUCKETS; b++) {                                    \
+                if (tails[b] - start > 1) {                                                   \
+                    radix_flag_##name(v + start, tails[b] - start, plan, level + 1);          \
+                }                                                                             \
+                start = tails[b];                                                             \
+            }                                                                                 \
+            return;                                                                           \
+        }                                                                                     \
+        if (count <= RADIX_INSERTION_COUNT) {                                                 \
+            insertion(v, count);                                                              \
+        } else {                                                                              \
+            exhausted(v, count);                                                              \
+        }                                                                                     \
+    }
+
+#define RADIX_SORT_IN_PLACE_TIE_DEFINE(name, T, K, key_func, tie_key_func, less_func)         \
+    static void                                                                               \
+    radix_insertion_sort_##name(T *v, u64 count) {                                            \
+        for (u64 i = 1; i < count; i++) {                                                     \
+            T e = v[i];                                                                       \
+            u64 j = i;                                                                        \
+            while (j > 0 && less_func(e, v[j - 1])) {                                         \
+                v[j] = v[j - 1];                                                              \
+                j--;                                                                          \
+            }                                                                                 \
+            v[j] = e;                                                                         \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static void                                                                               \
+    radix_sift_down_##name(T *v, u64 root, u64 count) {                                       \
+        T e = v[root];                                                                        \
+        for (;;) {                                                                            \
+            u64 child = 2 * root + 1;                                                         \
+            if (child >= count) break;                                                        \
+            if (child + 1 < count && less_func(v[child], v[child + 1])) child++;              \
+            if (!less_func(e, v[child])) break;                                               \
+            v[root] = v[child];                                                               \
+            root = child;                                                                     \
+        }                                                                                     \
+        v[root] = e;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static void                                                                               \
+    radix_heap_sort_##name(T *v, u64 count) {                                                 \
+        for (u64 i = count / 2; i-- > 0;) {                                                   \
+            radix_sift_down_##name(v, i, count);                                              \
+        }                                                                                     \
+        for (u64 end = count - 1; end > 0; end--) {                                           \
+            T top = v[0];                                                                     \
+            v[0] = v[end];                                                                    \
+            v[end] = top;                                                                     \
+            radix_sift_down_##name(v, 0, end);                                                \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    RADIX_FLAG_LEVELS_(name##_tie, T, tie_key_func, radix_insertion_sort_##name,              \
+                       radix_heap_sort_##name)                                                \
+                                                                                              \
+    static void                                                                               \
+    radix_tie_sort_##name(T *v, u64 count) {                                                  \
+        u64 key_or = 0, key_and = MAX_U64;                                                    \
+        for (u64 i = 0; i < count; i++) {                                                     \
+            u64 key = (u64)tie_key_func(&v[i]);                                               \
+            key_or |= key;                                                                    \
+            key_and &= key;                                                                   \
+        }                                                                                     \
+        Radix_Plan plan = radix_plan_from_digits(key_or ^ key_and, RADIX_BITS);               \
+        radix_flag_##name##_tie(v, count, &plan, 0);                                          \
+    }                                                                                         \
+                                                                                              \
+    RADIX_FLAG_LEVELS_(name, T, key_func, radix_insertion_sort_##name,                        \
+                       radix_tie_sort_##name)                                                 \
+                                                                                              \
+    static void                                                                               \
+    radix_sort_##name##_in_place(T *elements, u64 count) {                                    \
+        if (count <= 1) return;                                                               \
+        u64 key_or = 0, key_and = MAX_U64;                                                    \
+        for (u64 i = 0; i < count; i++) {                                                     \
+            u64 key = (u64)key_func(&elements[i]);                                            \
+            key_or |= key;                                                                    \
+            key_and &= key;                                                                   \
+        }                                                                                     \
+        Radix_Plan plan = radix_plan_from_digits(key_or ^ key_and, RADIX_BITS);               \
+        radix_flag_##name(elements, count, &plan, 0);                                         \
+    }                                                                                         \
+                                                                                              \
+    static void                                                                               \
+    radix_sort_##name##_in_place_lane(T *elements, u64 count,                                 \
+                                      u64 *lane_histograms, u64 *global_histogram) {          \
+        if (count <= 1) return;                                                               \
+        Rng1U64 my_range = lane_range(count);                                                 \
+        u64 key_or = 0, key_and = MAX_U64;                                                    \
+        for (u64 i = my_range.min; i < my_range.max; i++) {                                   \
+            u64 key = (u64)key_func(&elements[i]);                                            \
+            key_or |= key;                                                                    \
+            key_and &= key;                                                                   \
+        }                                                                                     \
+        Radix_Plan plan = radix_plan_from_digits(                                             \
+            radix_lane_diff_mask(lane_histograms, key_or, key_and), RADIX_BITS);              \
+        if (plan.pass_count == 0 || count <= RADIX_INSERTION_COUNT) {                         \
+            if (lane_idx() == 0) {                                                            \
+                radix_flag_##name(elements, count, &plan, plan.pass_count);                   \
+            }                                                                                 \
+            lane_sync();                                                                      \
+            return;                                                                           \
+        }                                                                                     \
+        u32 shift = plan.shift[plan.pass_count - 1];                                          \
+        u64 *my_histogram = lane_histograms + lane_idx() * RADIX_FLAG_BUCKETS;                \
+        MemoryZero(my_histogram, RADIX_FLAG_BUCKETS * sizeof(u64));                           \
+        for (u64 i = my_range.min; i < my_range.max; i++) {                                   \
+            my_histogram[((u64)key_func(&elements[i]) >> shift) & (RADIX_FLAG_BUCKETS - 1)]++; \
+        }                                                                                     \
+        lane_sync();                                                                          \
+        radix_lane_prefix(lane_histograms, global_histogram, RADIX_FLAG_BUCKETS);             \
+        u64 heads[RADIX_FLAG_BUCKETS], tails[RADIX_FLAG_BUCKETS];                             \
+        for (u64 b = 0; b < RADIX_FLAG_BUCKETS; b++) {                                        \
+            heads[b] = global_histogram[b];                                                   \
+            tails[b] = b + 1 < RADIX_FLAG_BUCKETS ? global_histogram[b + 1] : count;          \
+        }                                                                                     \
+        if (lane_idx() == 0) {                                                                \
+            radix_flag_permute_##name(elements, shift, heads, tails);                         \
+        }                                                                                     \
+        lane_sync();                                                                          \
+        for (u64 b = 0; b < RADIX_FLAG_BUCKETS; b++) {                                        \
+            u64 start = global_histogram[b];                                                  \
+            u64 end = b + 1 < RADIX_FLAG_BUCKETS ? global_histogram[b + 1] : count;           \
+            if (start >= my_range.min && start < my_range.max && end - start > 1) {           \
+                radix_flag_##name(elements + start, end - start, &plan, 1);                   \
+            }                                                                                 \
+        }                                                                                     \
+        lane_sync();                                                                          \
+    }
+
+#define RADIX_SORT_DECLARE(name, T)                                                           \
+    static void radix_sort_##name(T *elements, u64 count, Arena *arena);                      \
+    static void radix_sort_##name##_lane(T *elements, u64 count, T *temp_buffer,              \
+                                         u64 *lane_histograms, u64 *global_histogram,         \
+                                         RadixFlags flags)
+
+#define RADIX_SORT_IN_PLACE_DECLARE(name, T)                                                  \
+    static void radix_sort_##name##_in_place(T *elements, u64 count);                         \
+    static void radix_sort_##name##_in_place_lane(T *elements, u64 count,                     \
+                                                  u64 *lane_histograms, u64 *global_histogram)
+
+RADIX_SORT_DECLARE(array_u64, u64);
+RADIX_SORT_DECLARE(array_u32, u32);
+RADIX_SORT_DECLARE(pair_u64, Sort_Pair_u64);
+RADIX_SORT_IN_PLACE_DECLARE(array_u64, u64);
+RADIX_SORT_IN_PLACE_DECLARE(array_u32, u32);
+RADIX_SORT_IN_PLACE_DECLARE(pair_u64, Sort_Pair_u64);
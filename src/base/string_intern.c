@@ -0,0 +1,127 @@
+#include "string_intern.h"
+
+static String_Intern_Table *
+str_intern_table_alloc(Arena *arena, u64 cap) {
+    String_Intern_Table *table = push_array(arena, String_Intern_Table, 1);
+    table->cap = cap;
+    table->slots = push_array(arena, u64, cap);
+    return table;
+}
+
+// Chunk i starts at id STR_INTERN_CHUNK_BASE * (2^i - 1).
+static String *
+str_intern_string_slot(String_Interner *interner, u32 id) {
+    u64     chunk_idx = log2_u64((u64)id / STR_INTERN_CHUNK_BASE + 1);
+    u64     chunk_first = STR_INTERN_CHUNK_BASE * ((1ull << chunk_idx) - 1);
+    String *chunk = (String *)ins_atomic_ptr_eval(&interner->chunks[chunk_idx]);
+    return chunk + (id - chunk_first);
+}
+
+static u32
+str_intern_find(String_Interner *interner, String_Intern_Table *table, String string, u64 hash) {
+    u64 mask = table->cap - 1;
+    u64 tag = hash >> 32;
+    for (u64 i = hash & mask;; i = (i + 1) & mask) {
+        u64 slot = ins_atomic_u64_eval(&table->slots[i]);
+        if (slot == 0) {
+            return STR_INTERN_ID_NONE;
+        }
+        if ((slot >> 32) == tag) {
+            u32 id = (u32)slot - 1;
+            if (str_match(*str_intern_string_slot(interner, id), string, 0)) {
+                return id;
+            }
+        }
+    }
+}
+
+static void
+str_intern_table_insert(String_Intern_Table *table, u64 hash, u32 id) {
+    u64 mask = table->cap - 1;
+    u64 i = hash & mask;
+    while (table->slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    ins_atomic_u64_eval_assign(&table->slots[i], (hash & 0xffffffff00000000ull) | ((u64)id + 1));
+}
+
+static String_Interner *
+str_interner_alloc(void) {
+    Arena           *arena = arena_alloc();
+    String_Interner *interner = push_array(arena, String_Interner, 1);
+    interner->arena = arena;
+    interner->mutex = mutex_alloc();
+    interner->table = str_intern_table_alloc(arena, STR_INTERN_MIN_CAP);
+    return interner;
+}
+
+// Not thread-safe: every lane must be done with the interner.
+static void
+str_interner_release(String_Interner *interner) {
+    if (!interner)
+        return;
+    mutex_release(interner->mutex);
+    arena_release(interner->arena);
+}
+
+static u32
+str_intern_lookup(String_Interner *interner, String string) {
+    String_Intern_Table *table = (String_Intern_Table *)ins_atomic_ptr_eval(&interner->table);
+    return str_intern_find(interner, table, string, u64_hash_from_str(string));
+}
+
+static u32
+str_intern(String_Interner *interner, String string) {
+    u64                  hash = u64_hash_from_str(string);
+    String_Intern_Table *table = (String_Intern_Table *)ins_atomic_ptr_eval(&interner->table);
+    u32                  id = str_intern_find(interner, table, string, hash);
+    if (id != STR_INTERN_ID_NONE) {
+        return id;
+    }
+
+    MutexScope(interner->mutex) {
+        // Another lane may have added it since the unlocked probe.
+        table = interner->table;
+        id = str_intern_find(interner, table, string, hash);
+        if (id == STR_INTERN_ID_NONE) {
+            id = interner->count;
+            u64 chunk_idx = log2_u64((u64)id / STR_INTERN_CHUNK_BASE + 1);
+            if (!interner->chunks[chunk_idx]) {
+                String *chunk = push_array(interner->arena, String, STR_INTERN_CHUNK_BASE << chunk_idx);
+                ins_atomic_ptr_eval_assign(&interner->chunks[chunk_idx], chunk);
+            }
+            *str_intern_string_slot(interner, id) = str_push_copy(interner->arena, string);
+            // Count first: a reader that finds the id in the table must
+            // also be able to resolve it.
+            ins_atomic_u32_eval_assign(&interner->count, id + 1);
+
+            // Keep the load under 1/2; readers still probing the old table
+            // just see it without the new id.
+            if ((u64)(id + 1) * 2 > table->cap) {
+                String_Intern_Table *grown = str_intern_table_alloc(interner->arena, table->cap * 2);
+                for (u32 i = 0; i < id; i++) {
+                    String *s = str_intern_string_slot(interner, i);
+                    str_intern_table_insert(grown, u64_hash_from_str(*s), i);
+                }
+                table = grown;
+            }
+            str_intern_table_insert(table, hash, id);
+            ins_atomic_ptr_eval_assign(&interner->table, table);
+        }
+    }
+    return id;
+}
+
+static String
+str_from_intern_id(String_Interner *interner, u32 id) {
+    String result = {0};
+    if (id < ins_atomic_u32_eval(&interner->count)) {
+        result = *str_intern_string_slot(interner, id);
+    }
+    return result;
+}
+
+static u32
+str_intern_count(String_Interner *interner) {
+    return ins_atomic_u32_eval(&interner->count);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Interns Strings to dense u32 ids, 0..count-1 in first-seen order, so hot
+// code can compare and hash ids instead of bytes. Interned bytes are copied
+// into the interner's own arena and stay put until it's released.
+//
+// Lookups (str_intern_lookup, str_from_intern_id) take no lock and can run
+// on any lane while another lane interns. str_intern tries the lock-free
+// path first and only takes the mutex to add a new string. That works
+// because nothing readers can see ever moves: the table is rebuilt into a
+// fresh arena block on growth and swapped in with one pointer store, and
+// the id -> String array is split into doubling chunks that are never
+// reallocated.
+//
+// A table slot packs the high 32 bits of the XXH3 hash with id+1, so a
+// probe compares bytes only on a 32-bit tag match; 0 marks an empty slot.
+
+#define STR_INTERN_ID_NONE      MAX_U32
+#define STR_INTERN_MIN_CAP      64
+#define STR_INTERN_CHUNK_BASE   64 // Chunk i holds STR_INTERN_CHUNK_BASE << i ids
+#define STR_INTERN_CHUNK_COUNT  26 // Ids up to 64 * (2^26 - 1), just short of MAX_U32
+
+typedef struct String_Intern_Table String_Intern_Table;
+struct String_Intern_Table {
+    u64  cap; // Power of two
+    u64 *slots;
+};
+
+typedef struct String_Interner String_Interner;
+struct String_Interner {
+    Arena               *arena;
+    Mutex                mutex;
+    String_Intern_Table *table;
+    u32                  count;
+    String              *chunks[STR_INTERN_CHUNK_COUNT];
+};
+
+static String_Interner *str_interner_alloc(void);
+static void             str_interner_release(String_Interner *interner);
+static u32              str_intern(String_Interner *interner, String string);
+static u32              str_intern_lookup(String_Interner *interner, String string);
+static String           str_from_intern_id(String_Interner *interner, u32 id);
+static u32              str_intern_count(String_Interner *interner);
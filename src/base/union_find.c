@@ -0,0 +1,83 @@
+#include "union_find.h"
+
+// Knuth's multiplier is odd, so this is a bijection on u32 and two distinct
+// roots never tie.
+static inline u32
+union_find_priority(u32 x) {
+    return hash_u32(x);
+}
+
+Union_Find
+union_find_alloc(Arena *arena, u64 count) {
+    Union_Find uf = {0};
+    uf.parent = push_array_no_zero(arena, u32, count);
+    uf.count = count;
+    union_find_reset(&uf);
+    return uf;
+}
+
+void
+union_find_reset(Union_Find *uf) {
+    for (u64 i = 0; i < uf->count; i++) {
+        uf->parent[i] = (u32)i;
+    }
+}
+
+void
+union_find_reset_lane(Union_Find *uf) {
+    Rng1U64 range = lane_range(uf->count);
+    for (u64 i = range.min; i < range.max; i++) {
+        uf->parent[i] = (u32)i;
+    }
+    lane_sync();
+}
+
+u32
+union_find_find(Union_Find *uf, u32 x) {
+    for (;;) {
+        u32 p = ins_atomic_u32_eval(&uf->parent[x]);
+        if (p == x) {
+            return x;
+        }
+        u32 gp = ins_atomic_u32_eval(&uf->parent[p]);
+        if (gp != p) {
+            ins_atomic_u32_eval_cond_assign(&uf->parent[x], gp, p);
+        }
+        x = gp;
+    }
+}
+
+b32
+union_find_union(Union_Find *uf, u32 a, u32 b) {
+    for (;;) {
+        a = union_find_find(uf, a);
+        b = union_find_find(uf, b);
+        if (a == b) {
+            return 0;
+        }
+        if (union_find_priority(a) > union_find_priority(b)) {
+            Swap(u32, a, b);
+        }
+        // a is the lower priority root. Linking fails only if a was linked
+        // by another lane since the find, in which case walk up and retry.
+        if (ins_atomic_u32_eval_cond_assign(&uf->parent[a], b, a) == a) {
+            return 1;
+        }
+    }
+}
+
+b32
+union_find_same(Union_Find *uf, u32 a, u32 b) {
+    for (;;) {
+        a = union_find_find(uf, a);
+        b = union_find_find(uf, b);
+        if (a == b) {
+            return 1;
+        }
+        // a may have been linked under another root after it was found.
+        // Only a stable root proves the two sets were separate.
+        if (ins_atomic_u32_eval(&uf->parent[a]) == a) {
+            return 0;
+        }
+    }
+}
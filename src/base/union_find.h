@@ -0,0 +1,23 @@
+#pragma once
+
+// Lock-free disjoint set forest.
+// Every operation is safe to call from all lanes at once:
+// - find is wait-free and compresses with path halving, where each hop is a
+//   CAS that may fail harmlessly when another lane got there first.
+// - union links one root under the other with a CAS on the root's parent and
+//   retries only if that root stopped being a root in the meantime.
+// Roots are ordered by a hashed priority instead of rank, so there is no
+// second array to keep consistent and trees stay shallow in expectation.
+
+typedef struct Union_Find Union_Find;
+struct Union_Find {
+    u32 *parent;
+    u64  count;
+};
+
+Union_Find union_find_alloc(Arena *arena, u64 count);
+void       union_find_reset(Union_Find *uf);
+void       union_find_reset_lane(Union_Find *uf);
+u32        union_find_find(Union_Find *uf, u32 x);
+b32        union_find_union(Union_Find *uf, u32 a, u32 b);
+b32        union_find_same(Union_Find *uf, u32 a, u32 b);
@@ -22,18 +22,19 @@ entry_point(Cmd_Line *cmd_line) {
     return;
   }
 
-  String day_padded = str_pushf(arena, "%02llu", day_num);
-  String file_path = str_pushf(arena, "src/puzzles/day_%.*s.c",
-                               (int)day_padded.size, day_padded.str);
+  // The formatter has no zero-padding spec.
+  String day_padded = str_pushf(arena, "{s}{u}", day_num < 10 ? "0" : "", (u32)day_num);
+  String file_path = str_pushf(arena, "src/puzzles/day_{S}.c", day_padded);
 
   if (os_file_path_exists(file_path)) {
     print("File already exists: {S}\n", file_path);
     return;
   }
 
+  // '{{' emits a literal brace.
   String template = str_pushf(
       arena,
-      "// Advent of Code 2026 - Day %llu\n"
+      "// Advent of Code 2026 - Day {u}\n"
       "\n"
       "#include \"base/base_inc.h\"\n"
       "#include \"os/os_inc.h\"\n"
@@ -42,44 +43,45 @@ entry_point(Cmd_Line *cmd_line) {
       "#include \"os/os_inc.c\"\n"
       "\n"
       "void\n"
-      "solve_part1(Arena *arena, String input) {\n"
+      "solve_part1(Arena *arena, String input) {{\n"
       "    // @TODO(Alex): Implement part 1\n"
-      "    print(\"Part 1: %{s}\\n\", \"not implemented\");\n"
+      "    print(\"Part 1: {{s}\\n\", \"not implemented\");\n"
       "}\n"
       "\n"
       "void\n"
-      "solve_part2(Arena *arena, String input) {\n"
+      "solve_part2(Arena *arena, String input) {{\n"
       "    // @TODO(Alex): Implement part 2\n"
-      "    print(\"Part 2: %{s}\\n\", \"not implemented\");\n"
+      "    print(\"Part 2: {{s}\\n\", \"not implemented\");\n"
       "}\n"
       "\n"
       "void\n"
-      "entry_point(Cmd_Line *cmd_line) {\n"
+      "entry_point(Cmd_Line *cmd_line) {{\n"
       "    Arena *arena = arena_alloc();\n"
       "    log_init(arena, str_lit(\"\"));\n"
       "\n"
-      "    // Read input file\n"
-      "    String input_path = str_lit(\"inputs/day_%.*s.txt\");\n"
-      "    String input = os_data_from_file_path(arena, input_path);\n"
-      "    if (input.size == 0) {\n"
-      "        print(\"Error: Could not read %%.*s\\n\", (int)input_path.size, "
-      "input_path.str);\n"
+      "    // Map the input file read-only; parsers see it straight from the\n"
+      "    // page cache. It isn't NUL-terminated.\n"
+      "    String input_path = str_lit(\"inputs/day_{S}.txt\");\n"
+      "    String input = os_data_map_from_file_path(input_path);\n"
+      "    if (input.size == 0) {{\n"
+      "        print(\"Error: Could not read {{S}\\n\", input_path);\n"
       "        return;\n"
       "    }\n"
       "\n"
-      "    print(\"=== Day %llu ===\\n\");\n"
+      "    print(\"=== Day {u} ===\\n\");\n"
       "    solve_part1(arena, input);\n"
       "    solve_part2(arena, input);\n"
       "\n"
+      "    os_data_unmap(input);\n"
       "    arena_release(arena);\n"
       "}\n",
-      day_num, (int)day_padded.size, day_padded.str, day_num);
+      (u32)day_num, day_padded, (u32)day_num);
 
   b32 success = os_write_data_to_file(file_path, template);
   if (success) {
     print("Created: {S}\n", file_path);
   } else {
-    print("Error: Failed to write %.*s\n", (int)file_path.size, file_path.str);
+    print("Error: Failed to write {S}\n", file_path);
   }
 
   arena_release(arena);
@@ -47,6 +47,41 @@ String os_data_from_file_path(Arena *arena, String path) {
     return data;
 }
 
+// Read-only view of the whole file, straight from the page cache: no copy
+// and no arena pages to fault in. Not NUL-terminated. Empty or missing
+// files give an empty String. Release with os_data_unmap.
+String os_data_map_from_file_path(String path) {
+    String    result = {0};
+    OS_Handle file = os_file_open(OS_Access_Flag_Read | OS_Access_Flag_Share_Read, path);
+    if (os_handle_match(file, os_handle_zero())) {
+        return result;
+    }
+    File_Properties props = os_properties_from_file(file);
+    if (props.size != 0) {
+        OS_Handle map = os_file_map_open(OS_Access_Flag_Read, file);
+        Rng1_u64  range = {0, props.size};
+        u8       *base = (u8 *)os_file_map_view_open(map, OS_Access_Flag_Read, range);
+        if (base) {
+            // Parsers walk the input front to back: read ahead aggressively
+            // and drop pages behind the cursor first.
+            madvise(base, props.size, MADV_SEQUENTIAL);
+            result.str = base;
+            result.size = props.size;
+        }
+        os_file_map_close(map);
+    }
+    // The mapping keeps its own reference to the file.
+    os_file_close(file);
+    return result;
+}
+
+void os_data_unmap(String data) {
+    if (data.str) {
+        Rng1_u64 range = {0, data.size};
+        os_file_map_view_close(os_handle_zero(), data.str, range);
+    }
+}
+
 b32 os_write_data_to_file(String path, String data) {
     OS_Handle file = os_file_open(OS_Access_Flag_Write, path);
     if (os_handle_match(file, os_handle_zero())) {
@@ -259,6 +294,182 @@ OS_System_Info *os_get_system_info(void) {
     return &os_posix_state.system_info;
 }
 
+#if OS_LINUX
+// Reads a small sysfs file. Returns an empty string if it does not exist.
+static String os_posix_sysfs_read(Arena *arena, String path) {
+    String result = {0};
+    int    fd = open((char *)path.str, O_RDONLY);
+    if (fd >= 0) {
+        u64     cap = 256;
+        u8     *buffer = push_array_no_zero(arena, u8, cap);
+        ssize_t size = read(fd, buffer, cap - 1);
+        if (size > 0) {
+            while (size > 0 && (buffer[size - 1] == '\n' || buffer[size - 1] == ' ')) {
+                size -= 1;
+            }
+            buffer[size] = 0;
+            result.str = buffer;
+            result.size = (u64)size;
+        }
+        close(fd);
+    }
+    return result;
+}
+
+// Parses "48K" / "2M" style sizes as well as plain numbers.
+static u64 os_posix_sysfs_u64(Arena *arena, String path, u64 fallback) {
+    String text = os_posix_sysfs_read(arena, path);
+    if (text.size == 0) {
+        return fallback;
+    }
+    u64 shift = 0;
+    switch (text.str[text.size - 1]) {
+    case 'K': shift = 10; text.size -= 1; break;
+    case 'M': shift = 20; text.size -= 1; break;
+    case 'G': shift = 30; text.size -= 1; break;
+    }
+    return u64_from_str(text, 10) << shift;
+}
+#endif
+
+// Fills in core / SMT / NUMA / cache details. Anything the platform does not
+// report falls back to one core per logical CPU on a single node.
+static void os_posix_topology_init(Arena *arena, OS_System_Info *info) {
+    u32 cpu_count = info->logical_processors;
+    info->cpus = push_array(arena, OS_CPU_Info, cpu_count);
+    info->cpu_order = push_array(arena, u32, cpu_count);
+    info->physical_cores = cpu_count;
+    info->smt_width = 1;
+    info->numa_node_count = 1;
+    info->cache_line_size = 64;
+    for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+        info->cpus[cpu].core_idx = cpu;
+    }
+
+#if OS_LINUX
+    Scratch scratch = arena_get_scratch(&arena, 1);
+
+    // core_id is only unique within a package, so key cores by both.
+    u64 *core_keys = push_array(scratch.arena, u64, cpu_count);
+    u32 *core_threads = push_array(scratch.arena, u32, cpu_count);
+    u32  core_count = 0;
+    for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+        String package_path = str_pushf(scratch.arena, "/sys/devices/system/cpu/cpu{u}/topology/physical_package_id", cpu);
+        String core_path = str_pushf(scratch.arena, "/sys/devices/system/cpu/cpu{u}/topology/core_id", cpu);
+        u64    package = os_posix_sysfs_u64(scratch.arena, package_path, 0);
+        u64    core = os_posix_sysfs_u64(scratch.arena, core_path, cpu);
+        u64    key = (package << 32) | (core & 0xffffffff);
+
+        u32 core_idx = 0;
+        while (core_idx < core_count && core_keys[core_idx] != key) {
+            core_idx += 1;
+        }
+        if (core_idx == core_count) {
+            core_keys[core_count++] = key;
+        }
+        info->cpus[cpu].core_idx = core_idx;
+        info->cpus[cpu].smt_idx = core_threads[core_idx]++;
+        info->smt_width = Max(info->smt_width, core_threads[core_idx]);
+    }
+    info->physical_cores = Max(core_count, 1);
+
+    // Node directories are numbered densely on every system we care about;
+    // stop at the first gap.
+    for (u32 node = 0; node < 1024; node++) {
+        String list_path = str_pushf(scratch.arena, "/sys/devices/system/node/node{u}/cpulist", node);
+        String list = os_posix_sysfs_read(scratch.arena, list_path);
+        if (list.size == 0) {
+            break;
+        }
+        info->numa_node_count = node + 1;
+
+        // "0-3,8-11"
+        u64 pos = 0;
+        while (pos < list.size) {
+            u64 first = 0;
+            while (pos < list.size && char_is_digit(list.str[pos])) {
+                first = first * 10 + (list.str[pos++] - '0');
+            }
+            u64 last = first;
+            if (pos < list.size && list.str[pos] == '-') {
+                pos += 1;
+                last = 0;
+                while (pos < list.size && char_is_digit(list.str[pos])) {
+                    last = last * 10 + (list.str[pos++] - '0');
+                }
+            }
+            for (u64 cpu = first; cpu <= last && cpu < cpu_count; cpu++) {
+                info->cpus[cpu].numa_node = node;
+            }
+            pos += 1;
+        }
+    }
+
+    for (u32 index = 0; index < 8; index++) {
+        String dir = str_pushf(scratch.arena, "/sys/devices/system/cpu/cpu0/cache/index{u}", index);
+        String type = os_posix_sysfs_read(scratch.arena, str_pushf(scratch.arena, "{S}/type", dir));
+        if (type.size == 0) {
+            break;
+        }
+        if (str_match(type, str_lit("Instruction"), 0)) {
+            continue;
+        }
+        u64 level = os_posix_sysfs_u64(scratch.arena, str_pushf(scratch.arena, "{S}/level", dir), 0);
+        u64 size = os_posix_sysfs_u64(scratch.arena, str_pushf(scratch.arena, "{S}/size", dir), 0);
+        u64 line = os_posix_sysfs_u64(scratch.arena, str_pushf(scratch.arena, "{S}/coherency_line_size", dir), 0);
+        switch (level) {
+        case 1: info->l1_cache_size = size; break;
+        case 2: info->l2_cache_size = size; break;
+        case 3: info->l3_cache_size = size; break;
+        }
+        if (level == 1 && line != 0) {
+            info->cache_line_size = line;
+        }
+    }
+
+    arena_end_scratch(&scratch);
+#elif OS_MAC
+    int    value = 0;
+    size_t value_len = sizeof(value);
+    if (sysctlbyname("hw.physicalcpu", &value, &value_len, NULL, 0) == 0 && value > 0) {
+        info->physical_cores = (u32)value;
+        info->smt_width = (cpu_count + info->physical_cores - 1) / info->physical_cores;
+        for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+            info->cpus[cpu].core_idx = cpu / info->smt_width;
+            info->cpus[cpu].smt_idx = cpu % info->smt_width;
+        }
+    }
+    u64    size = 0;
+    size_t size_len = sizeof(size);
+    if (sysctlbyname("hw.cachelinesize", &size, &size_len, NULL, 0) == 0) {
+        info->cache_line_size = size;
+    }
+    size_len = sizeof(size);
+    if (sysctlbyname("hw.l1dcachesize", &size, &size_len, NULL, 0) == 0) {
+        info->l1_cache_size = size;
+    }
+    size_len = sizeof(size);
+    if (sysctlbyname("hw.l2cachesize", &size, &size_len, NULL, 0) == 0) {
+        info->l2_cache_size = size;
+    }
+    size_len = sizeof(size);
+    if (sysctlbyname("hw.l3cachesize", &size, &size_len, NULL, 0) == 0) {
+        info->l3_cache_size = size;
+    }
+#endif
+
+    // Order CPUs by SMT index, so pinning lane i to cpu_order[i] puts the
+    // first physical_cores lanes on distinct cores.
+    u32 order_count = 0;
+    for (u32 smt = 0; smt < info->smt_width; smt++) {
+        for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+            if (info->cpus[cpu].smt_idx == smt) {
+                info->cpu_order[order_count++] = cpu;
+            }
+        }
+    }
+}
+
 OS_Process_Info *os_get_process_info(void) {
     return &os_posix_state.process_info;
 }
@@ -317,20 +528,89 @@ void os_decommit(void *ptr, u64 size) {
     mprotect(ptr, size, PROT_NONE);
 }
 
+// Faults in committed pages now, so the first pass over them does not. On
+// Linux 5.14+ one madvise populates the whole range (MAP_POPULATE only works
+// at mmap time, and MADV_WILLNEED does nothing for anonymous memory);
+// elsewhere every page gets written once.
+#if OS_LINUX && !defined(MADV_POPULATE_WRITE)
+#    define MADV_POPULATE_WRITE 23
+#endif
+
+void os_prefault(void *ptr, u64 size) {
+#if OS_LINUX
+    if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    u64 page_size = os_posix_state.system_info.page_size ? os_posix_state.system_info.page_size : KB(4);
+    for (u64 off = 0; off < size; off += page_size) {
+        ((volatile u8 *)ptr)[off] = 0;
+    }
+}
+
 void os_mem_release(void *ptr, u64 size) {
     munmap(ptr, size);
 }
 
-void *os_reserve_large(u64 size) {
 #if OS_LINUX
-    void *result = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
-    if (result == MAP_FAILED) {
+// THP is usable unless the admin set it to "never"; madvise(MADV_HUGEPAGE)
+// succeeds either way, so it can't tell us.
+static b32 os_posix_thp_enabled(void) {
+    static s32 enabled = -1;
+    if (enabled < 0) {
+        enabled = 0;
+        int fd = open("/sys/kernel/mm/transparent_hugepage/enabled", O_RDONLY);
+        if (fd >= 0) {
+            char    buffer[64] = {0};
+            ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+            close(fd);
+            String text = {(u8 *)buffer, size > 0 ? (u64)size : 0};
+            enabled = (text.size > 0 && str_find_needle(text, 0, str_lit("[never]"), 0) == text.size);
+        }
+    }
+    return (b32)enabled;
+}
+#endif
+
+// Explicit huge pages first, since they need no promotion, but they only
+// exist if the host reserved a hugetlbfs pool. Otherwise the range is
+// aligned to 2MB and advised for THP, and failing that it is a normal
+// reservation. Never returns null just because large pages are missing.
+void *os_reserve_large(u64 size, OS_Large_Page_Mode *mode_out) {
+    OS_Large_Page_Mode mode = OS_Large_Page_Mode_None;
+    void              *result = 0;
+#if OS_LINUX
+    result = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (result != MAP_FAILED) {
+        mode = OS_Large_Page_Mode_Explicit;
+    } else {
         result = 0;
+        u64 align = MB(2);
+        u64 padded_size = size + align;
+        u8 *raw = (u8 *)mmap(0, padded_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw != MAP_FAILED) {
+            u8 *aligned = (u8 *)PtrFromInt(AlignUpPow2(IntFromPtr(raw), align));
+            u64 head = (u64)(aligned - raw);
+            u64 tail = padded_size - head - size;
+            if (head != 0) {
+                munmap(raw, head);
+            }
+            if (tail != 0) {
+                munmap(aligned + size, tail);
+            }
+            result = aligned;
+            if (os_posix_thp_enabled() && madvise(aligned, size, MADV_HUGEPAGE) == 0) {
+                mode = OS_Large_Page_Mode_Transparent;
+            }
+        }
     }
-    return result;
 #else
-    return os_reserve(size);
+    result = os_reserve(size);
 #endif
+    if (mode_out) {
+        *mode_out = mode;
+    }
+    return result;
 }
 
 b32 os_commit_large(void *ptr, u64 size) {
@@ -338,6 +618,48 @@ b32 os_commit_large(void *ptr, u64 size) {
     return 1;
 }
 
+// mbind through the raw syscall, so there is no libnuma dependency. The
+// policy sticks to the range and applies as pages are first faulted in;
+// pages that already exist stay where they are.
+#if OS_LINUX
+#    define OS_POSIX_MPOL_BIND       2
+#    define OS_POSIX_MPOL_INTERLEAVE 3
+#    define OS_POSIX_NUMA_MAX_NODES  1024
+
+static b32 os_posix_mbind(void *ptr, u64 size, int mode, u64 *node_mask) {
+    b32 result = (syscall(SYS_mbind, ptr, size, mode, node_mask, (u64)OS_POSIX_NUMA_MAX_NODES, 0) == 0);
+    return result;
+}
+#endif
+
+b32 os_numa_bind(void *ptr, u64 size, u32 node) {
+    b32 result = 0;
+#if OS_LINUX
+    u32 node_count = os_posix_state.system_info.numa_node_count;
+    if (node < node_count && node < OS_POSIX_NUMA_MAX_NODES) {
+        u64 node_mask[OS_POSIX_NUMA_MAX_NODES / 64] = {0};
+        node_mask[node / 64] |= 1ull << (node % 64);
+        result = os_posix_mbind(ptr, size, OS_POSIX_MPOL_BIND, node_mask);
+    }
+#endif
+    return result;
+}
+
+b32 os_numa_interleave(void *ptr, u64 size) {
+    b32 result = 0;
+#if OS_LINUX
+    u32 node_count = Min(os_posix_state.system_info.numa_node_count, OS_POSIX_NUMA_MAX_NODES);
+    if (node_count > 1) {
+        u64 node_mask[OS_POSIX_NUMA_MAX_NODES / 64] = {0};
+        for (u32 node = 0; node < node_count; node++) {
+            node_mask[node / 64] |= 1ull << (node % 64);
+        }
+        result = os_posix_mbind(ptr, size, OS_POSIX_MPOL_INTERLEAVE, node_mask);
+    }
+#endif
+    return result;
+}
+
 u32 os_tid(void) {
 #if OS_LINUX
     u32 result = gettid();
@@ -412,16 +734,43 @@ u64 os_file_read(OS_Handle file, Rng1_u64 rng, void *out_data) {
     u64 total_num_bytes_left_to_read = total_num_bytes_to_read;
     for (; total_num_bytes_left_to_read > 0;) {
         int read_result = pread(fd, (u8 *)out_data + total_num_bytes_read, total_num_bytes_left_to_read, rng.min + total_num_bytes_read);
-        if (read_result >= 0) {
+        if (read_result > 0) {
             total_num_bytes_read += read_result;
             total_num_bytes_left_to_read -= read_result;
-        } else if (errno != EINTR) {
+        } else if (read_result == 0 || errno != EINTR) {
+            // 0 is end of file: a range past it comes back short.
             break;
         }
     }
     return total_num_bytes_read;
 }
 
+// Tells the kernel the file will be read front to back, so it reads ahead
+// in larger windows.
+void os_file_hint_sequential(OS_Handle file) {
+    if (os_handle_match(file, os_handle_zero())) {
+        return;
+    }
+    int fd = (int)file.v[0];
+#if OS_LINUX
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#elif OS_MAC
+    fcntl(fd, F_RDAHEAD, 1);
+#endif
+}
+
+// The range won't be read again: its pages can leave the page cache, so
+// streaming a huge file doesn't evict everything else.
+void os_file_hint_drop(OS_Handle file, Rng1_u64 range) {
+    if (os_handle_match(file, os_handle_zero())) {
+        return;
+    }
+#if OS_LINUX
+    int fd = (int)file.v[0];
+    posix_fadvise(fd, range.min, range.max - range.min, POSIX_FADV_DONTNEED);
+#endif
+}
+
 u64 os_file_write(OS_Handle file, Rng1_u64 rng, void *data) {
     if (os_handle_match(file, os_handle_zero())) {
         return 0;
@@ -953,6 +1302,24 @@ void os_thread_detach(Thread handle) {
     os_posix_entity_release(entity);
 }
 
+// Pins a thread to one logical CPU. A zero handle pins the calling thread.
+// macOS only has affinity tags, which are a hint, so it reports failure.
+b32 os_thread_set_affinity(Thread handle, u32 cpu_idx) {
+    b32 result = 0;
+#if OS_LINUX
+    pthread_t thread = pthread_self();
+    if (!MemoryIsZeroStruct(&handle)) {
+        OS_Posix_Entity *entity = (OS_Posix_Entity *)handle.v[0];
+        thread = entity->thread.handle;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu_idx, &set);
+    result = (pthread_setaffinity_np(thread, sizeof(set), &set) == 0);
+#endif
+    return result;
+}
+
 Mutex os_mutex_alloc(void) {
     OS_Posix_Entity *entity = os_posix_entity_alloc(OS_Posix_Entity_Kind_Mutex);
     int              init_result = pthread_mutex_init(&entity->mutex_handle, 0);
@@ -1278,10 +1645,18 @@ void os_semaphore_drop(Semaphore semaphore) {
 
 
 #if OS_LINUX
+// Roughly tens of microseconds of polling before a waiter sleeps.
+#define OS_BARRIER_SPIN_COUNT 4096
+
 Barrier os_barrier_alloc(u64 count) {
     OS_Posix_Entity *entity = os_posix_entity_alloc(OS_Posix_Entity_Kind_Barrier);
     if (entity != 0) {
-        pthread_barrier_init(&entity->barrier, 0, count);
+        MemoryZeroStruct(&entity->barrier);
+        entity->barrier.trip_count = (u32)count;
+        // With more lanes than cores a spinner only burns the slice the last
+        // lane needs, so go straight to the futex.
+        b32 oversubscribed = count > os_posix_state.system_info.logical_processors;
+        entity->barrier.spin_count = oversubscribed ? 0 : OS_BARRIER_SPIN_COUNT;
     }
     Barrier result = {(u64)entity};
     return result;
@@ -1290,15 +1665,39 @@ Barrier os_barrier_alloc(u64 count) {
 void os_barrier_release(Barrier barrier) {
     OS_Posix_Entity *entity = (OS_Posix_Entity *)barrier.v[0];
     if (entity != 0) {
-        pthread_barrier_destroy(&entity->barrier);
         os_posix_entity_release(entity);
     }
 }
 
 void os_barrier_wait(Barrier barrier) {
     OS_Posix_Entity *entity = (OS_Posix_Entity *)barrier.v[0];
-    if (entity != 0) {
-        pthread_barrier_wait(&entity->barrier);
+    if (entity == 0) {
+        return;
+    }
+
+    // Read the generation before arriving, so a release that happens in
+    // between is still seen as a change.
+    u32 generation = ins_atomic_u32_eval(&entity->barrier.generation);
+    if (ins_atomic_u32_inc_eval(&entity->barrier.arrived) == entity->barrier.trip_count) {
+        ins_atomic_u32_eval_assign(&entity->barrier.arrived, 0);
+        ins_atomic_u32_inc_eval(&entity->barrier.generation);
+        // Waiters raise sleeping before they check the generation in the
+        // kernel, so either they see the bump or we see the flag.
+        if (ins_atomic_u32_eval_assign(&entity->barrier.sleeping, 0)) {
+            syscall(SYS_futex, &entity->barrier.generation, FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+        }
+        return;
+    }
+
+    for (u32 i = 0; i < entity->barrier.spin_count; i += 1) {
+        if (ins_atomic_u32_eval(&entity->barrier.generation) != generation) {
+            return;
+        }
+        ins_pause();
+    }
+    while (ins_atomic_u32_eval(&entity->barrier.generation) == generation) {
+        ins_atomic_u32_eval_assign(&entity->barrier.sleeping, 1);
+        syscall(SYS_futex, &entity->barrier.generation, FUTEX_WAIT_PRIVATE, generation, 0, 0, 0);
     }
 }
 #elif OS_MAC
@@ -29,6 +29,7 @@
 #    include <linux/limits.h>
 #    include <sys/sysinfo.h>
 #    include <sys/sendfile.h>
+#    include <linux/futex.h>
 pid_t gettid(void);
 int   pthread_setname_np(pthread_t thread, const char *name);
 int   pthread_getname_np(pthread_t thread, char *name, size_t size);
@@ -89,7 +90,18 @@ struct OS_Posix_Entity {
             pthread_mutex_t rwlock_mutex_handle;
         } cv;
 #if OS_LINUX
-        pthread_barrier_t barrier;
+        // Generation barrier: the last lane in resets the arrival count and
+        // bumps the generation, which is also the futex word waiters sleep
+        // on. The two live on separate cache lines so arrivals do not
+        // disturb spinners.
+        struct {
+            u32 arrived;
+            u32 trip_count;
+            u32 spin_count;
+            u8  pad[52];
+            u32 generation;
+            u32 sleeping; // Set by waiters about to enter the futex
+        } barrier;
 #elif OS_MAC
         struct {
             u64 count;
@@ -120,6 +132,7 @@ static timespec        os_posix_timespec_from_date_time(Date_Time dt);
 static Dense_Time      os_posix_dense_time_from_timespec(timespec in);
 static File_Properties os_posix_file_properties_from_state(struct stat *s);
 static void            os_posix_safe_call_sig_handler(int x);
+static void            os_posix_topology_init(Arena *arena, OS_System_Info *info);
 
 static OS_Posix_Entity *os_posix_entity_alloc(OS_Posix_Entity_Kind kind);
 static void             os_posix_entity_release(OS_Posix_Entity *entity);
@@ -76,6 +76,7 @@ int main(int argc, char **argv) {
         }
 		
         os_posix_state.arena = arena_alloc();
+        os_posix_topology_init(os_posix_state.arena, &os_posix_state.system_info);
         os_posix_state.entity_arena = arena_alloc();
         pthread_mutex_init(&os_posix_state.entity_mutex, 0);
 		
@@ -97,6 +98,9 @@ int main(int argc, char **argv) {
                 for (s64 cap = PATH_MAX, r = 0; r < 4; cap *= 2, r += 1) {
                     arena_end_scratch(&scratch);
                     buffer = push_array_no_zero(scratch.arena, u8, cap);
+                    if (!buffer) {
+                        break;
+                    }
                     ssize_t result = readlink("/proc/self/exe", (char *)buffer, cap);
                     if (result >= 0 && result < cap) {
                         size = result;
@@ -147,6 +151,7 @@ int main(int argc, char **argv) {
     Cmd_Line cmd_line = cmd_line_from_string_list(scratch.arena, args_list);
 	
     entry_point(&cmd_line);
+    str_interner_release(cmd_line.option_names);
 	
     arena_end_scratch(&scratch);
 	
@@ -31,6 +31,38 @@ String os_data_from_file_path(Arena *arena, String path) {
     return data;
 }
 
+// Read-only view of the whole file, straight from the page cache: no copy
+// and no arena pages to fault in. Not NUL-terminated. Empty or missing
+// files give an empty String. Release with os_data_unmap.
+String os_data_map_from_file_path(String path) {
+    String    result = {0};
+    OS_Handle file = os_file_open(OS_Access_Flag_Read | OS_Access_Flag_Share_Read, path);
+    if (os_handle_match(file, os_handle_zero())) {
+        return result;
+    }
+    File_Properties props = os_properties_from_file(file);
+    if (props.size != 0) {
+        OS_Handle map = os_file_map_open(OS_Access_Flag_Read, file);
+        Rng1_u64  range = {0, props.size};
+        u8       *base = (u8 *)os_file_map_view_open(map, OS_Access_Flag_Read, range);
+        if (base) {
+            result.str = base;
+            result.size = props.size;
+        }
+        // The view keeps the section and file alive until it's unmapped.
+        os_file_map_close(map);
+    }
+    os_file_close(file);
+    return result;
+}
+
+void os_data_unmap(String data) {
+    if (data.str) {
+        Rng1_u64 range = {0, data.size};
+        os_file_map_view_close(os_handle_zero(), data.str, range);
+    }
+}
+
 static Date_Time os_w32_date_time_from_system_time(SYSTEMTIME *in) {
     Date_Time dt = {0};
     dt.year = in->wYear;
@@ -139,6 +171,81 @@ OS_System_Info *os_get_system_info(void) {
     return &os_w32_state.system_info;
 }
 
+// Fills in core / SMT / NUMA / cache details from the processor relations.
+// Only the calling thread's processor group (the first 64 CPUs) is covered.
+static void os_w32_topology_init(Arena *arena, OS_System_Info *info) {
+    u32 cpu_count = info->logical_processors;
+    info->cpus = push_array(arena, OS_CPU_Info, cpu_count);
+    info->cpu_order = push_array(arena, u32, cpu_count);
+    info->physical_cores = cpu_count;
+    info->smt_width = 1;
+    info->numa_node_count = 1;
+    info->cache_line_size = 64;
+    for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+        info->cpus[cpu].core_idx = cpu;
+    }
+
+    Scratch scratch = arena_get_scratch(&arena, 1);
+    DWORD   size = 0;
+    GetLogicalProcessorInformation(0, &size);
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *relations = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *)push_array(scratch.arena, u8, size);
+    if (size != 0 && GetLogicalProcessorInformation(relations, &size)) {
+        u64 relation_count = size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        u32 core_count = 0;
+        u32 node_max = 0;
+        for (u64 i = 0; i < relation_count; i++) {
+            SYSTEM_LOGICAL_PROCESSOR_INFORMATION *r = &relations[i];
+            switch (r->Relationship) {
+            case RelationProcessorCore: {
+                u32 smt_idx = 0;
+                for (u32 cpu = 0; cpu < cpu_count && cpu < 64; cpu++) {
+                    if (r->ProcessorMask & (1ull << cpu)) {
+                        info->cpus[cpu].core_idx = core_count;
+                        info->cpus[cpu].smt_idx = smt_idx++;
+                    }
+                }
+                info->smt_width = Max(info->smt_width, smt_idx);
+                core_count += 1;
+            } break;
+            case RelationNumaNode: {
+                for (u32 cpu = 0; cpu < cpu_count && cpu < 64; cpu++) {
+                    if (r->ProcessorMask & (1ull << cpu)) {
+                        info->cpus[cpu].numa_node = r->NumaNode.NodeNumber;
+                    }
+                }
+                node_max = Max(node_max, r->NumaNode.NodeNumber);
+            } break;
+            case RelationCache: {
+                CACHE_DESCRIPTOR *cache = &r->Cache;
+                if (cache->Type == CacheInstruction) {
+                    break;
+                }
+                switch (cache->Level) {
+                case 1: info->l1_cache_size = cache->Size; info->cache_line_size = cache->LineSize; break;
+                case 2: info->l2_cache_size = cache->Size; break;
+                case 3: info->l3_cache_size = cache->Size; break;
+                }
+            } break;
+            default: break;
+            }
+        }
+        info->physical_cores = Max(core_count, 1);
+        info->numa_node_count = node_max + 1;
+    }
+    arena_end_scratch(&scratch);
+
+    // Order CPUs by SMT index, so pinning lane i to cpu_order[i] puts the
+    // first physical_cores lanes on distinct cores.
+    u32 order_count = 0;
+    for (u32 smt = 0; smt < info->smt_width; smt++) {
+        for (u32 cpu = 0; cpu < cpu_count; cpu++) {
+            if (info->cpus[cpu].smt_idx == smt) {
+                info->cpu_order[order_count++] = cpu;
+            }
+        }
+    }
+}
+
 OS_Process_Info *os_get_process_info(void) {
     return &os_w32_state.process_info;
 }
@@ -180,12 +287,35 @@ void os_decommit(void *ptr, u64 size) {
     VirtualFree(ptr, size, MEM_DECOMMIT);
 }
 
+// Faults in freshly committed pages so the first pass over them does not.
+void os_prefault(void *ptr, u64 size) {
+    u64 page_size = os_w32_state.system_info.page_size ? os_w32_state.system_info.page_size : KB(4);
+    for (u64 off = 0; off < size; off += page_size) {
+        ((volatile u8 *)ptr)[off] = 0;
+    }
+}
+
 void os_mem_release(void *ptr, u64 size) {
     VirtualFree(ptr, 0, MEM_RELEASE);
 }
 
-void *os_reserve_large(u64 size) {
-    void *result = VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+// Large pages need SeLockMemoryPrivilege and come back committed. Without
+// them this is a normal reservation: Windows has no transparent huge pages.
+void *os_reserve_large(u64 size, OS_Large_Page_Mode *mode_out) {
+    OS_Large_Page_Mode mode = OS_Large_Page_Mode_None;
+    void              *result = 0;
+    SIZE_T             large_page_size = GetLargePageMinimum();
+    if (large_page_size != 0 && size % large_page_size == 0) {
+        result = VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+    if (result) {
+        mode = OS_Large_Page_Mode_Explicit;
+    } else {
+        result = os_reserve(size);
+    }
+    if (mode_out) {
+        *mode_out = mode;
+    }
     return result;
 }
 
@@ -193,6 +323,17 @@ b32 os_commit_large(void *ptr, u64 size) {
     return 1;
 }
 
+// Windows picks the node when memory is committed (VirtualAllocExNuma), not
+// per reserved range, so these report failure and the arena keeps the
+// default policy, which already prefers the faulting thread's node.
+b32 os_numa_bind(void *ptr, u64 size, u32 node) {
+    return 0;
+}
+
+b32 os_numa_interleave(void *ptr, u64 size) {
+    return 0;
+}
+
 u32 os_tid(void) {
     DWORD id = GetCurrentThreadId();
     return (u32)id;
@@ -311,6 +452,14 @@ u64 os_file_read(OS_Handle file, Rng1_u64 rng, void *out_data) {
     return total_read_size;
 }
 
+// No per-handle equivalent after the fact: sequential read-ahead is
+// chosen at CreateFile time (FILE_FLAG_SEQUENTIAL_SCAN).
+void os_file_hint_sequential(OS_Handle file) {
+}
+
+void os_file_hint_drop(OS_Handle file, Rng1_u64 range) {
+}
+
 u64 os_file_write(OS_Handle file, Rng1_u64 rng, void *data) {
     if (os_handle_match(file, os_handle_zero())) {
         return 0;
@@ -834,6 +983,20 @@ void os_thread_detach(Thread handle) {
     os_w32_entity_release(entity);
 }
 
+// Pins a thread to one logical CPU. A zero handle pins the calling thread.
+b32 os_thread_set_affinity(Thread handle, u32 cpu_idx) {
+    if (cpu_idx >= 64) {
+        return 0;
+    }
+    HANDLE thread = GetCurrentThread();
+    if (!MemoryIsZeroStruct(&handle)) {
+        OS_W32_Entity *entity = (OS_W32_Entity *)handle.v[0];
+        thread = entity->thread.handle;
+    }
+    b32 result = (SetThreadAffinityMask(thread, 1ull << cpu_idx) != 0);
+    return result;
+}
+
 Mutex os_mutex_alloc(void) {
     OS_W32_Entity *entity = os_w32_entity_alloc(OS_W32_Entity_Kind_Mutex);
     InitializeCriticalSection(&entity->mutex_handle);
@@ -1135,6 +1298,7 @@ static void win32_entry_point(int argc, WCHAR **wargv) {
     CoInitializeEx(0, COINIT_MULTITHREADED);
 
     os_w32_state.arena = arena_alloc();
+    os_w32_topology_init(os_w32_state.arena, &os_w32_state.system_info);
     os_w32_state.entity_arena = arena_alloc();
     InitializeCriticalSection(&os_w32_state.entity_mutex);
 
@@ -1181,6 +1345,7 @@ static void win32_entry_point(int argc, WCHAR **wargv) {
     Cmd_Line cmd_line = cmd_line_from_string_list(scratch.arena, args_list);
 
     entry_point(&cmd_line);
+    str_interner_release(cmd_line.option_names);
 
     arena_end_scratch(&scratch);
 }
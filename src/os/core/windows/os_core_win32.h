@@ -77,6 +77,7 @@ static OS_W32_Entity *os_w32_entity_alloc(OS_W32_Entity_Kind kind);
 static void           os_w32_entity_release(OS_W32_Entity *entity);
 
 static DWORD WINAPI os_w32_thread_entry_point(void *ptr);
+static void         os_w32_topology_init(Arena *arena, OS_System_Info *info);
 
 static File_Properties os_w32_file_properties_from_find_data(WIN32_FIND_DATAW *fd);
 static File_Properties os_w32_file_properties_from_handle(HANDLE handle);
@@ -5,10 +5,26 @@
 #include "../base/math.h"
 #include "os_thread.h"
 
+typedef struct OS_CPU_Info OS_CPU_Info;
+struct OS_CPU_Info {
+    u32 core_idx;  // Dense physical core index, unique across packages
+    u32 smt_idx;   // 0 for the first hardware thread of its core
+    u32 numa_node;
+};
+
 typedef struct OS_System_Info OS_System_Info;
 struct OS_System_Info {
-    u32 logical_processors;
-    u64 page_size;
+    u32          logical_processors;
+    u32          physical_cores;
+    u32          smt_width;        // Hardware threads per core, at most
+    u32          numa_node_count;
+    u64          page_size;
+    u64          cache_line_size;
+    u64          l1_cache_size;    // Data cache, per core
+    u64          l2_cache_size;
+    u64          l3_cache_size;
+    OS_CPU_Info *cpus;             // logical_processors entries
+    u32         *cpu_order;        // One CPU per core first, then SMT siblings
 };
 
 typedef u32 Data_Access_Flags;
@@ -116,6 +132,8 @@ void                    os_handle_list_push(Arena *arena, OS_Handle_List *handle
 OS_Handle_Array         os_handle_array_from_list(Arena *arena, OS_Handle_List list);
 
 String      os_data_from_file_path(Arena *arena, String path);
+String      os_data_map_from_file_path(String path);
+void        os_data_unmap(String data);
 b32         os_write_data_to_file(String path, String data);
 b32         os_write_data_list_to_file_path(String path, String_List list);
 b32         os_append_data_to_file_path(String path, String data);
@@ -137,11 +155,15 @@ u64              os_now_microseconds(void);
 void *os_reserve(u64 size);
 b32   os_commit(void *ptr, u64 size);
 void  os_decommit(void *ptr, u64 size);
+void  os_prefault(void *ptr, u64 size);
 void  os_mem_release(void *ptr, u64 size);
 
-void *os_reserve_large(u64 size);
+void *os_reserve_large(u64 size, OS_Large_Page_Mode *mode_out);
 b32   os_commit_large(void *ptr, u64 size);
 
+b32 os_numa_bind(void *ptr, u64 size, u32 node);
+b32 os_numa_interleave(void *ptr, u64 size);
+
 u32  os_tid(void);
 void os_set_thread_name(String string);
 
@@ -157,6 +179,8 @@ b32             os_file_set_times(OS_Handle file, Date_Time time);
 File_Properties os_properties_from_file(OS_Handle file);
 OS_File_ID      os_id_from_file(OS_Handle file);
 b32             os_file_reserve_size(OS_Handle file, u64 size);
+void            os_file_hint_sequential(OS_Handle file);
+void            os_file_hint_drop(OS_Handle file, Rng1_u64 range);
 b32             os_delete_file_at_path(String path);
 b32             os_copy_file_path(String dst, String src);
 b32             os_move_file_path(String dst, String src);
@@ -185,6 +209,7 @@ void      os_shared_memory_view_close(OS_Handle handle, void *ptr, Rng1_u64 rang
 Thread os_thread_launch(Thread_Entry_Point *func, void *ptr);
 b32    os_thread_join(Thread thread, u64 endt_us);
 void   os_thread_detach(Thread thread);
+b32    os_thread_set_affinity(Thread thread, u32 cpu_idx);
 
 Mutex os_mutex_alloc(void);
 void  os_mutex_release(Mutex mutex);
@@ -14,6 +14,8 @@
 #    include "core/posix/os_core_posix_entry.c"
 #endif
 
+#include "os_stream.c"
+
 #if defined(__linux__)
 #    include "gfx/gfx_x11.c"
 #elif defined(__APPLE__)
@@ -9,3 +9,5 @@
 #elif OS_LINUX || OS_MAC
 #    include "core/posix/os_core_posix.h"
 #endif
+
+#include "os_stream.h"
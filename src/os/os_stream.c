@@ -0,0 +1,102 @@
+static void os_stream_reader_thread(void *p) {
+    OS_Stream *stream = (OS_Stream *)p;
+    u64        offset = 0;
+    for (u64 i = 0;; i++) {
+        semaphore_take(stream->free_count, MAX_U64);
+        if (ins_atomic_u32_eval(&stream->stop)) {
+            break;
+        }
+        OS_Stream_Buffer *buffer = &stream->buffers[i % OS_STREAM_BUFFER_COUNT];
+        Rng1_u64          range = {offset, offset + stream->chunk_size};
+        buffer->offset = offset;
+        buffer->size = os_file_read(stream->file, range, buffer->base + stream->chunk_size);
+        offset += buffer->size;
+        semaphore_drop(stream->ready_count);
+        // A short read is the end of the file (possibly an empty buffer, when
+        // the size is a multiple of the chunk size).
+        if (buffer->size < stream->chunk_size) {
+            break;
+        }
+    }
+}
+
+// Returns 0 if the file can't be opened. A chunk_size of 0 picks
+// OS_STREAM_DEFAULT_CHUNK_SIZE.
+OS_Stream *os_stream_open(Arena *arena, String path, u64 chunk_size) {
+    OS_Handle file = os_file_open(OS_Access_Flag_Read | OS_Access_Flag_Share_Read, path);
+    if (os_handle_match(file, os_handle_zero())) {
+        return 0;
+    }
+    os_file_hint_sequential(file);
+
+    OS_Stream *stream = push_array(arena, OS_Stream, 1);
+    stream->file = file;
+    stream->chunk_size = chunk_size ? chunk_size : OS_STREAM_DEFAULT_CHUNK_SIZE;
+    for (u64 i = 0; i < OS_STREAM_BUFFER_COUNT; i++) {
+        stream->buffers[i].base = push_array(arena, u8, 2 * stream->chunk_size);
+    }
+    stream->free_count = semaphore_alloc(OS_STREAM_BUFFER_COUNT, OS_STREAM_BUFFER_COUNT + 1, str_lit(""));
+    stream->ready_count = semaphore_alloc(0, OS_STREAM_BUFFER_COUNT, str_lit(""));
+    stream->reader = thread_launch(os_stream_reader_thread, stream);
+    return stream;
+}
+
+// Returns an empty String once the file is exhausted.
+String os_stream_next(OS_Stream *stream) {
+    String result = {0};
+    if (stream->done) {
+        return result;
+    }
+
+    semaphore_take(stream->ready_count, MAX_U64);
+    OS_Stream_Buffer *buffer = &stream->buffers[stream->next_buffer];
+    stream->next_buffer = (stream->next_buffer + 1) % OS_STREAM_BUFFER_COUNT;
+
+    // Carry the previous chunk's partial line into the headroom, then hand
+    // its buffer back to the reader. There's no tail before the first chunk,
+    // and memmove's source must not be null even for a size of 0.
+    u8 *data = buffer->base + stream->chunk_size;
+    u8 *first = data - stream->tail_size;
+    if (stream->tail_size) {
+        MemoryCopy(first, stream->tail, stream->tail_size);
+    }
+    if (stream->held) {
+        Rng1_u64 consumed = {stream->held->offset, stream->held->offset + stream->held->size};
+        os_file_hint_drop(stream->file, consumed);
+        semaphore_drop(stream->free_count);
+    }
+    stream->held = buffer;
+
+    u8 *opl = data + buffer->size;
+    u8 *end = opl;
+    if (buffer->size == stream->chunk_size) {
+        while (end > first && end[-1] != '\n') {
+            end -= 1;
+        }
+        // No newline, or a partial line too long for the headroom: split it.
+        if (end == first || (u64)(opl - end) > stream->chunk_size) {
+            end = opl;
+        }
+    } else {
+        stream->done = 1;
+    }
+    stream->tail = end;
+    stream->tail_size = (u64)(opl - end);
+
+    result.str = first;
+    result.size = (u64)(end - first);
+    return result;
+}
+
+void os_stream_close(OS_Stream *stream) {
+    if (!stream) {
+        return;
+    }
+    // The reader is either finished or waiting for a free buffer.
+    ins_atomic_u32_eval_assign(&stream->stop, 1);
+    semaphore_drop(stream->free_count);
+    thread_join(stream->reader, MAX_U64);
+    semaphore_release(stream->free_count);
+    semaphore_release(stream->ready_count);
+    os_file_close(stream->file);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Streams a file through a fixed ring of buffers in line-aligned chunks, for
+// inputs too big to hold as one String. A reader thread fills the next
+// buffer with os_file_read while the caller parses the current one, so
+// parsing overlaps I/O and memory stays at OS_STREAM_BUFFER_COUNT buffers
+// however big the file is.
+//
+// Every chunk but the last ends just past a '\n'. The partial line at the
+// end of one buffer is copied in front of the next, so lines only get split
+// when they're longer than the chunk size. A chunk stays valid until the
+// next os_stream_next call.
+//
+//   OS_Stream *stream = os_stream_open(arena, path, MB(4));
+//   for (String chunk = os_stream_next(stream); chunk.size; chunk = os_stream_next(stream)) {
+//       ...
+//   }
+//   os_stream_close(stream);
+
+#define OS_STREAM_BUFFER_COUNT       2
+#define OS_STREAM_DEFAULT_CHUNK_SIZE MB(4)
+
+typedef struct OS_Stream_Buffer OS_Stream_Buffer;
+struct OS_Stream_Buffer {
+    u8 *base;   // chunk_size of headroom for the carried line, then chunk_size of data
+    u64 offset; // File offset of the data
+    u64 size;   // Bytes read; short only at the end of the file
+};
+
+typedef struct OS_Stream OS_Stream;
+struct OS_Stream {
+    OS_Handle        file;
+    u64              chunk_size;
+    Thread           reader;
+    Semaphore        free_count;  // Buffers the reader may fill
+    Semaphore        ready_count; // Filled buffers waiting for the caller
+    b32              stop;
+    OS_Stream_Buffer buffers[OS_STREAM_BUFFER_COUNT];
+
+    // Caller side
+    u64               next_buffer;
+    OS_Stream_Buffer *held; // Buffer behind the last chunk
+    u8               *tail; // Partial line at the end of `held`
+    u64               tail_size;
+    b32               done;
+};
+
+OS_Stream *os_stream_open(Arena *arena, String path, u64 chunk_size);
+String     os_stream_next(OS_Stream *stream);
+void       os_stream_close(OS_Stream *stream);
@@ -246,13 +246,48 @@ solve_part2(Arena *arena, String input, Run_Flag flag) {
           (u32)elapsed_us);
 }
 
+// Reads the input through an OS_Stream. Chunks arrive in file order and
+// only split lines longer than chunk_size, so joining them gives back the
+// file; debug builds check that against a whole-file read.
+static String
+input_from_stream(Arena *arena, String path, u64 chunk_size) {
+    String     result = {0};
+    Scratch    scratch = arena_get_scratch(&arena, 1);
+    OS_Stream *stream = os_stream_open(scratch.arena, path, chunk_size);
+    if (stream) {
+        String_List chunks = {0};
+        for (String chunk = os_stream_next(stream); chunk.size; chunk = os_stream_next(stream)) {
+            str_list_push(scratch.arena, &chunks, str_push_copy(scratch.arena, chunk));
+        }
+        os_stream_close(stream);
+        String_Join join = {0};
+        join.pre = str_lit("");
+        join.mid = str_lit("");
+        join.post = str_lit("");
+        result = str_list_join(arena, &chunks, &join);
+#if DEBUG_MODE
+        String whole = os_data_from_file_path(scratch.arena, path);
+        Assert(str_match(result, whole, 0));
+#endif
+    }
+    arena_end_scratch(&scratch);
+    return result;
+}
+
 void
 entry_point(Cmd_Line *cmd_line) {
     Arena *arena = arena_alloc();
     log_init(arena, str_lit(""));
 
     String input_path = str_lit("inputs/day_01.txt");
-    String input = os_data_from_file_path(arena, input_path);
+    // -stream[:chunk_bytes] reads it in chunks instead of in one go.
+    String input = {0};
+    if (cmd_line_has_flag(cmd_line, str_lit("stream"))) {
+        u64 chunk_size = u64_from_str(cmd_line_string(cmd_line, str_lit("stream")), 10);
+        input = input_from_stream(arena, input_path, chunk_size);
+    } else {
+        input = os_data_from_file_path(arena, input_path);
+    }
     if (input.size == 0) {
         print("Error: Could not read %.*s\n", (int)input_path.size, input_path.str);
         return;
@@ -356,6 +356,64 @@ solve_part2(Arena *arena, String input, Part2RangeFn range_fn, char *label) {
     print("Part 2 ({s}): {s} (time: {u} us)\n", label, buf, (u32)elapsed_us);
 }
 
+typedef struct Range_Job Range_Job;
+struct Range_Job {
+    Part2RangeFn range_fn;
+    u64          start;
+    u64          end;
+    Pool        *pool;
+    u64         *total;
+};
+
+// Whichever worker runs the job frees it, into its own pool cache.
+static void
+range_job(void *data) {
+    Range_Job *job = (Range_Job *)data;
+    ins_atomic_u64_add_eval(job->total, job->range_fn(job->start, job->end));
+    pool_free_array(job->pool, job, 1);
+}
+
+// Same as solve_part2, but every range becomes a job. Range sizes vary a lot,
+// so idle workers steal whatever is left instead of taking a fixed share.
+void
+solve_part2_jobs(Pool *pool, String input, Part2RangeFn range_fn, char *label) {
+    u64 total_sum = 0;
+    Job_Counter counter = {0};
+
+    u8 *ptr = input.str;
+    u8 *end = input.str + input.size;
+
+    u64 start_time = os_now_microseconds();
+
+    while (ptr < end) {
+        while (ptr < end && (char_is_whitespace(*ptr) || *ptr == ',')) ptr++;
+        if (ptr >= end) break;
+
+        u64 range_start = parse_number(&ptr, end);
+        if (ptr < end && *ptr == '-') ptr++;
+        u64 range_end = parse_number(&ptr, end);
+
+        if (range_end >= range_start) {
+            Range_Job *job = pool_push_array(pool, Range_Job, 1);
+            job->range_fn = range_fn;
+            job->start = range_start;
+            job->end = range_end;
+            job->pool = pool;
+            job->total = &total_sum;
+            job_spawn(&counter, range_job, job);
+        }
+    }
+    job_wait(&counter);
+
+    u64 end_time = os_now_microseconds();
+    u64 elapsed_us = end_time - start_time;
+
+    char buf[32];
+    u32 len = fmt_u64_to_str(total_sum, buf, 10);
+    buf[len] = 0;
+    print("Part 2 ({s}): {s} (time: {u} us)\n", label, buf, (u32)elapsed_us);
+}
+
 void
 entry_point(Cmd_Line *cmd_line) {
     Arena *arena = arena_alloc();
@@ -377,5 +435,11 @@ entry_point(Cmd_Line *cmd_line) {
     solve_part2(arena, input, solve_range_part2_scalar_fast, "scalar_fast");
     solve_part2(arena, input, solve_range_part2_simd, "simd");
 
+    job_system_init(arena, 0);
+    Pool *pool = pool_alloc();
+    solve_part2_jobs(pool, input, solve_range_part2_scalar_slow, "scalar_slow+jobs");
+    job_system_shutdown();
+    pool_release(pool);
+
     arena_release(arena);
 }
@@ -4,67 +4,127 @@
 #include "base/base_inc.c"
 #include "os/os_inc.c"
 
+#define KRUSKAL_CHUNK_SIZE 4096
+#define KRUSKAL_MARK_GRAIN 256
+
 typedef struct {
   u32 a, b;
   u64 dist_sq;
 } Edge;
 
+typedef struct {
+  u64 dist_sq;
+  u32 v;
+  u32 from;
+  u8 pad[48]; // One cache line per lane
+} Prim_Candidate;
+
 typedef struct {
   Lane_Ctx lane_ctx;
   Arena *arena;
   String input;
   Vec3_s32 *points;
   u64 point_count;
+  Vec3_s32_SoA points_soa;
   Edge *edges;
+  Edge *edge_temp; // Only with -lsd
+  RadixFlags radix_flags;
   u64 edge_count;
-  u64 *edge_idx_counter;
-  void *edge_temp;
+  Edge *topk_edges;
+  Shared_Arena *shared_arena;
   u64 *lane_histograms;
   u64 *global_histogram;
-  u32 *uf_parent;
-  u32 *uf_rank;
+  Union_Find *uf;
   u32 *uf_sizes;
+  u8 *kruskal_keep;
+  u64 *prim_min_dist;
+  u32 *prim_min_from;
+  u8 *prim_in_tree;
+  Prim_Candidate *prim_candidates;
+  b32 sparse_only;
+  u32 pin_cpu; // MAX_U32 when the lane isn't pinned
+  u64 *result_p1_topk;
   u64 *result_p1_slow;
   u64 *result_p1_fast;
   u64 *result_p2;
+  u64 *result_p2_prim;
+  u64 *time_p1_topk;
   u64 *time_p1_slow;
   u64 *time_p1_fast;
   u64 *time_p2;
+  u64 *time_p2_prim;
 } Thread_Params;
 
-static u32 uf_find(u32 *parent, u32 i) {
-  if (parent[i] != i) {
-    parent[i] = uf_find(parent, parent[i]);
-  }
-  return parent[i];
+// Orders by distance, then by endpoints, so every engine agrees on which pair
+// wins a tie.
+static inline b32 edge_less(Edge x, Edge y) {
+  if (x.dist_sq != y.dist_sq)
+    return x.dist_sq < y.dist_sq;
+  if (x.a != y.a)
+    return x.a < y.a;
+  return x.b < y.b;
 }
 
-static u32 uf_find_read_only(u32 *parent, u32 i) {
-  while (parent[i] != i) {
-    i = parent[i];
+static inline u64 edge_key(const Edge *e) { return e->dist_sq; }
+static inline u64 edge_tie_key(const Edge *e) { return ((u64)e->a << 32) | e->b; }
+
+// In place, so the edge list needs no second buffer. Runs of equal distance
+// are radix sorted again on the endpoints, which is edge_less order and
+// matches a stable sort of the generated list.
+RADIX_SORT_IN_PLACE_TIE_DEFINE(edge, Edge, u64, edge_key, edge_tie_key, edge_less)
+
+// -lsd sorts with the LSD lane sort instead. It's stable, so ties keep the
+// generated order, which is edge_less order; the price is a second
+// edge-sized buffer. -write-combine turns on its write-combining scatter.
+RADIX_SORT_DEFINE(edge_lsd, Edge, u64, edge_key)
+
+// Bounded max-heap holding the `cap` shortest edges seen so far. The root is
+// the worst edge kept, so rejecting a candidate costs a single compare.
+typedef struct {
+  Edge *v;
+  u64 count;
+  u64 cap;
+} Edge_Heap;
+
+static void edge_heap_sift_down(Edge *v, u64 count, u64 i, Edge e) {
+  for (;;) {
+    u64 child = 2 * i + 1;
+    if (child >= count)
+      break;
+    if (child + 1 < count && edge_less(v[child], v[child + 1]))
+      child++;
+    if (!edge_less(e, v[child]))
+      break;
+    v[i] = v[child];
+    i = child;
   }
-  return i;
+  v[i] = e;
 }
 
-static void uf_union(u32 *parent, u32 *rank, u32 a, u32 b) {
-  u32 ra = uf_find(parent, a);
-  u32 rb = uf_find(parent, b);
-  if (ra == rb)
-    return;
-
-  if (rank[ra] < rank[rb]) {
-    parent[ra] = rb;
-  } else if (rank[ra] > rank[rb]) {
-    parent[rb] = ra;
-  } else {
-    parent[rb] = ra;
-    rank[ra]++;
+static void edge_heap_push(Edge_Heap *heap, Edge e) {
+  if (heap->count < heap->cap) {
+    u64 i = heap->count++;
+    while (i > 0) {
+      u64 parent = (i - 1) / 2;
+      if (!edge_less(heap->v[parent], e))
+        break;
+      heap->v[i] = heap->v[parent];
+      i = parent;
+    }
+    heap->v[i] = e;
+  } else if (heap->cap > 0 && edge_less(e, heap->v[0])) {
+    edge_heap_sift_down(heap->v, heap->count, 0, e);
   }
 }
 
-static u64 edge_get_key(void *element) {
-  Edge *e = (Edge *)element;
-  return e->dist_sq;
+// Sorts the kept edges ascending in place. The heap property is gone
+// afterwards, so push nothing else.
+static void edge_heap_sort(Edge_Heap *heap) {
+  for (u64 n = heap->count; n > 1; n--) {
+    Edge last = heap->v[n - 1];
+    heap->v[n - 1] = heap->v[0];
+    edge_heap_sift_down(heap->v, n - 1, 0, last);
+  }
 }
 
 static u64 parse_points(String input, Vec3_s32 *points, u64 max_count) {
@@ -119,90 +179,189 @@ static u64 parse_points(String input, Vec3_s32 *points, u64 max_count) {
   return count;
 }
 
-static void generate_edges_lane(Vec3_s32 *points, u64 point_count, Edge *edges,
-                                u64 *edge_idx_counter) {
-  Rng1U64 range = lane_range(point_count);
+// Pairs (i, j) with i < j are laid out row by row, so row i starts after
+// the (N-1) + (N-2) + ... + (N-i) pairs of the rows before it.
+static inline u64 edge_row_offset(u64 row, u64 point_count) {
+  return row * (2 * point_count - row - 1) / 2;
+}
 
+// Each lane fills the lane_range slice of the edge list it first-touched,
+// so the pages it writes are the ones on its own node. Splitting by pairs
+// rather than rows also keeps the triangle's long first rows from landing on
+// one lane. A slice can start and end mid-row; every edge's slot follows from
+// the row offset, so the edge list comes out in the same order regardless.
+static void generate_edges_lane(Vec3_s32_SoA points, Edge *edges) {
+  u64 point_count = points.count;
+  u64 edge_count = (point_count * (point_count - 1)) / 2;
+  Rng1U64 slice = lane_range(edge_count);
+  if (slice.min >= slice.max)
+    return;
+
+  // Find the row holding the slice's first pair.
+  u64 lo = 0, hi = point_count - 1;
+  while (hi - lo > 1) {
+    u64 mid = (lo + hi) / 2;
+    if (edge_row_offset(mid, point_count) <= slice.min)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  u64 k = slice.min;
+  for (u64 i = lo; k < slice.max; i++) {
+    u64 row_start = edge_row_offset(i, point_count);
+    u64 row_end = Min(edge_row_offset(i + 1, point_count), slice.max);
+    Vec3_s32 p = {{points.x[i], points.y[i], points.z[i]}};
+    // Pair k of row i is (i, i + 1 + k - row_start).
+    for (u64 j = i + 1 + (k - row_start); k < row_end; j += 4) {
+      u64 dist_sq[4];
+      simd_dist_sq_s32(points.x + j, points.y + j, points.z + j, p, dist_sq);
+      u64 width = Min(4, row_end - k);
+      for (u64 w = 0; w < width; w++) {
+        Edge *e = &edges[k + w];
+        e->a = (u32)i;
+        e->b = (u32)(j + w);
+        e->dist_sq = dist_sq[w];
+      }
+      k += width;
+    }
+  }
+}
+
+// Lane-parallel top-k. Each lane streams its slice of the edge list once
+// through a bounded max-heap, then lane 0 merges the lane_count * k survivors
+// into `out`, sorted ascending. This replaces eight radix scatters over every
+// edge with one read pass when only the k shortest edges are needed. Each
+// lane allocates its own heap from the shared arena and gathers the result,
+// so nothing is sized per lane up front.
+static u64 select_topk_edges_lane(Edge *edges, u64 edge_count, u64 k,
+                                  Shared_Arena *shared_arena, Edge *out) {
+  u64 keep = Min(k, edge_count);
+  Rng1U64 range = lane_range(edge_count);
+
+  Edge_Heap heap = {push_array_shared(shared_arena, Edge, keep), 0, keep};
   for (u64 i = range.min; i < range.max; i++) {
-    for (u64 j = i + 1; j < point_count; j++) {
-      s64 dx = points[i].x - points[j].x;
-      s64 dy = points[i].y - points[j].y;
-      s64 dz = points[i].z - points[j].z;
-
-      u64 idx = ins_atomic_u64_inc_eval(edge_idx_counter) - 1;
-      edges[idx].a = (u32)i;
-      edges[idx].b = (u32)j;
-      edges[idx].dist_sq = (u64)(dx * dx + dy * dy + dz * dz);
+    edge_heap_push(&heap, edges[i]);
+  }
+
+  Scratch scratch = scratch_begin(0, 0);
+  Edge_Heap *lane_heaps = push_array(scratch.arena, Edge_Heap, lane_count());
+  lane_gather(&heap, sizeof(heap), lane_heaps);
+
+  if (lane_idx() == 0) {
+    Edge_Heap merged = {out, 0, keep};
+    for (u64 lane = 0; lane < lane_count(); lane++) {
+      for (u64 i = 0; i < lane_heaps[lane].count; i++) {
+        edge_heap_push(&merged, lane_heaps[lane].v[i]);
+      }
     }
+    edge_heap_sort(&merged);
+  }
+  lane_sync();
+
+  scratch_end(scratch);
+  return keep;
+}
+
+static void top3_insert(u32 *top3, u32 size) {
+  if (size > top3[0]) {
+    top3[2] = top3[1];
+    top3[1] = top3[0];
+    top3[0] = size;
+  } else if (size > top3[1]) {
+    top3[2] = top3[1];
+    top3[1] = size;
+  } else if (size > top3[2]) {
+    top3[2] = size;
   }
 }
 
+static u64 top3_size_product(u32 *sizes, u64 count) {
+  u32 top3[3] = {0, 0, 0};
+  for (u64 i = 0; i < count; i++) {
+    top3_insert(top3, sizes[i]);
+  }
+  return (u64)top3[0] * (u64)top3[1] * (u64)top3[2];
+}
+
 static u64 solve_part1_lane(Edge *edges, u64 edge_count, u64 point_count,
-                            u64 connections, u32 *parent, u32 *rank,
-                            u32 *sizes) {
+                            u64 connections, Union_Find *uf, u32 *sizes) {
   Rng1U64 init_range = lane_range(point_count);
   for (u64 i = init_range.min; i < init_range.max; i++) {
-    parent[i] = (u32)i;
-    rank[i] = 0;
     sizes[i] = 0;
   }
-  lane_sync();
+  union_find_reset_lane(uf);
 
-  if (lane_idx() == 0) {
-    u64 to_process = (connections < edge_count) ? connections : edge_count;
-    for (u64 i = 0; i < to_process; i++) {
-      uf_union(parent, rank, edges[i].a, edges[i].b);
-    }
+  u64 to_process = (connections < edge_count) ? connections : edge_count;
+  Rng1U64 edge_range = lane_range(to_process);
+  for (u64 i = edge_range.min; i < edge_range.max; i++) {
+    union_find_union(uf, edges[i].a, edges[i].b);
   }
   lane_sync();
 
   for (u64 i = init_range.min; i < init_range.max; i++) {
-    u32 root = uf_find_read_only(parent, (u32)i);
+    u32 root = union_find_find(uf, (u32)i);
     ins_atomic_u32_inc_eval(&sizes[root]);
   }
   lane_sync();
 
+  // Each lane keeps the top 3 of its own slice, then every lane merges the
+  // gathered candidates, so the product is known everywhere without lane 0
+  // rescanning all the sizes.
   u32 top3[3] = {0, 0, 0};
-  if (lane_idx() == 0) {
-    for (u64 i = 0; i < point_count; i++) {
-      if (sizes[i] > top3[0]) {
-        top3[2] = top3[1];
-        top3[1] = top3[0];
-        top3[0] = sizes[i];
-      } else if (sizes[i] > top3[1]) {
-        top3[2] = top3[1];
-        top3[1] = sizes[i];
-      } else if (sizes[i] > top3[2]) {
-        top3[2] = sizes[i];
-      }
-    }
+  for (u64 i = init_range.min; i < init_range.max; i++) {
+    top3_insert(top3, sizes[i]);
   }
 
-  return (u64)top3[0] * (u64)top3[1] * (u64)top3[2];
+  Scratch scratch = scratch_begin(0, 0);
+  u64 candidate_count = lane_count() * 3;
+  u32 *candidates = push_array(scratch.arena, u32, candidate_count);
+  lane_gather(top3, sizeof(top3), candidates);
+
+  u64 result = top3_size_product(candidates, candidate_count);
+  scratch_end(scratch);
+  return result;
 }
 
+// Filter-Kruskal over the sorted edges, one chunk at a time. All lanes mark
+// the chunk's edges whose endpoints are still in different trees, which is
+// almost none of them once the forest is large. Find paths vary in length,
+// so lanes claim the marking in small pieces off a lane cursor rather than
+// fixed slices. Lane 0 then unions the marked edges in order, so the edge
+// that finally connects everything is the same one serial Kruskal would pick.
 static u64 solve_part2_lane(Vec3_s32 *points, Edge *edges, u64 edge_count,
-                            u64 point_count, u32 *parent, u32 *rank) {
-  Rng1U64 init_range = lane_range(point_count);
-  for (u64 i = init_range.min; i < init_range.max; i++) {
-    parent[i] = (u32)i;
-    rank[i] = 0;
-  }
-  lane_sync();
+                            u64 point_count, Union_Find *uf, u8 *keep) {
+  union_find_reset_lane(uf);
 
   u64 last_a = 0, last_b = 0;
-  if (lane_idx() == 0) {
-    u64 unions_made = 0;
-    for (u64 i = 0; i < edge_count && unions_made < point_count - 1; i++) {
-      u32 ra = uf_find(parent, edges[i].a);
-      u32 rb = uf_find(parent, edges[i].b);
-      if (ra != rb) {
-        uf_union(parent, rank, edges[i].a, edges[i].b);
-        last_a = edges[i].a;
-        last_b = edges[i].b;
-        unions_made++;
+  u64 unions_made = 0;
+  u64 done = (point_count < 2);
+  for (u64 base = 0; base < edge_count && !done; base += KRUSKAL_CHUNK_SIZE) {
+    Edge *chunk = edges + base;
+    u64 chunk_count = Min(KRUSKAL_CHUNK_SIZE, edge_count - base);
+
+    Lane_Cursor marks = lane_range_dynamic(chunk_count, KRUSKAL_MARK_GRAIN);
+    for EachLaneChunk(range, marks) {
+      for (u64 i = range.min; i < range.max; i++) {
+        keep[i] = !union_find_same(uf, chunk[i].a, chunk[i].b);
       }
     }
+    lane_sync();
+
+    if (lane_idx() == 0) {
+      for (u64 i = 0; i < chunk_count; i++) {
+        if (keep[i] && union_find_union(uf, chunk[i].a, chunk[i].b)) {
+          last_a = chunk[i].a;
+          last_b = chunk[i].b;
+          unions_made++;
+          if (unions_made == point_count - 1) {
+            done = 1;
+            break;
+          }
+        }
+      }
+    }
+    lane_sync_u64(&done, 0);
   }
 
   lane_sync_u64(&last_a, 0);
@@ -211,61 +370,350 @@ static u64 solve_part2_lane(Vec3_s32 *points, Edge *edges, u64 edge_count,
   return (u64)points[last_a].x * (u64)points[last_b].x;
 }
 
+// Dense Prim over the implicit complete graph, so no edge list is built.
+// Each lane owns a slice of the vertices and keeps their distance to the
+// tree. A step updates that slice against the vertex added last, publishes
+// the lane's closest vertex, and after one barrier every lane reduces the
+// same candidates to the same choice. Candidate slots alternate by step
+// parity, so a slot is never rewritten while another lane still reads it.
+// Kruskal's last union is the longest MST edge, which is what this returns.
+// O(N) memory, O(N^2 / lanes) work per lane.
+static u64 solve_part2_prim_lane(Vec3_s32_SoA points, u64 *min_dist,
+                                 u32 *min_from, u8 *in_tree,
+                                 Prim_Candidate *candidates) {
+  u64 point_count = points.count;
+  if (point_count < 2)
+    return 0;
+
+  Rng1U64 range = lane_range(point_count);
+  for (u64 i = range.min; i < range.max; i++) {
+    min_dist[i] = MAX_U64;
+    min_from[i] = 0;
+    in_tree[i] = (i == 0);
+  }
+  lane_sync();
+
+  u32 current = 0;
+  u64 longest = 0;
+  u32 longest_a = 0, longest_b = 0;
+  for (u64 step = 1; step < point_count; step++) {
+    Vec3_s32 c = {{points.x[current], points.y[current], points.z[current]}};
+    Prim_Candidate best = {MAX_U64, MAX_U32, 0};
+    for (u64 base = range.min; base < range.max; base += 4) {
+      u64 dist_sq[4];
+      simd_dist_sq_s32(points.x + base, points.y + base, points.z + base, c,
+                       dist_sq);
+      u64 width = Min(4, range.max - base);
+      for (u64 w = 0; w < width; w++) {
+        u64 v = base + w;
+        if (in_tree[v])
+          continue;
+        if (dist_sq[w] < min_dist[v]) {
+          min_dist[v] = dist_sq[w];
+          min_from[v] = current;
+        }
+        if (min_dist[v] < best.dist_sq) {
+          best.dist_sq = min_dist[v];
+          best.v = (u32)v;
+          best.from = min_from[v];
+        }
+      }
+    }
+
+    Prim_Candidate *slots = candidates + (step & 1) * lane_count();
+    slots[lane_idx()] = best;
+    lane_sync();
+
+    best = slots[0];
+    for (u64 lane = 1; lane < lane_count(); lane++) {
+      Prim_Candidate other = slots[lane];
+      if (other.dist_sq < best.dist_sq ||
+          (other.dist_sq == best.dist_sq && other.v < best.v)) {
+        best = other;
+      }
+    }
+
+    if (best.dist_sq >= longest) {
+      longest = best.dist_sq;
+      longest_a = best.from;
+      longest_b = best.v;
+    }
+    current = best.v;
+    if (current >= range.min && current < range.max) {
+      in_tree[current] = 1;
+    }
+  }
+
+  return (u64)points.x[longest_a] * (u64)points.x[longest_b];
+}
+
+// Uniform grid hashed into a power-of-two bucket table. Points are grouped by
+// bucket with a counting sort, so each bucket is a contiguous run of indices.
+// Every point also keeps its packed cell key, which filters out points that
+// only share a bucket through a hash collision.
+typedef struct {
+  Vec3_s32 min;
+  s64 cell_size;
+  u32 bucket_shift;
+  u32 *bucket_start; // bucket_count + 1 entries
+  u32 *point_idx;
+  u64 *cell_key; // indexed by point
+} Point_Grid;
+
+static inline u64 grid_key_from_cell(s64 cx, s64 cy, s64 cz) {
+  return ((u64)cx & 0x1fffff) | (((u64)cy & 0x1fffff) << 21) |
+         (((u64)cz & 0x1fffff) << 42);
+}
+
+static inline u64 grid_key_from_point(Point_Grid *grid, Vec3_s32 p) {
+  s64 cx = ((s64)p.x - grid->min.x) / grid->cell_size;
+  s64 cy = ((s64)p.y - grid->min.y) / grid->cell_size;
+  s64 cz = ((s64)p.z - grid->min.z) / grid->cell_size;
+  return grid_key_from_cell(cx, cy, cz);
+}
+
+static inline u64 grid_bucket_from_key(Point_Grid *grid, u64 key) {
+  return hash_u64(key) >> grid->bucket_shift;
+}
+
+static Point_Grid point_grid_build(Arena *arena, Vec3_s32 *points, u64 count,
+                                   Vec3_s32 min, s64 cell_size) {
+  Point_Grid grid = {0};
+  grid.min = min;
+  grid.cell_size = cell_size;
+
+  u64 bucket_count = 2;
+  while (bucket_count < count)
+    bucket_count <<= 1;
+  grid.bucket_shift = 64 - (u32)log2_u64(bucket_count);
+  grid.bucket_start = push_array(arena, u32, bucket_count + 1);
+  grid.point_idx = push_array_no_zero(arena, u32, count);
+  grid.cell_key = push_array_no_zero(arena, u64, count);
+
+  for (u64 i = 0; i < count; i++) {
+    u64 key = grid_key_from_point(&grid, points[i]);
+    grid.cell_key[i] = key;
+    grid.bucket_start[grid_bucket_from_key(&grid, key) + 1]++;
+  }
+  for (u64 b = 0; b < bucket_count; b++) {
+    grid.bucket_start[b + 1] += grid.bucket_start[b];
+  }
+
+  u32 *cursor = push_array_copy(arena, u32, bucket_count, grid.bucket_start);
+  for (u64 i = 0; i < count; i++) {
+    u64 b = grid_bucket_from_key(&grid, grid.cell_key[i]);
+    grid.point_idx[cursor[b]++] = (u32)i;
+  }
+  return grid;
+}
+
+// Finds the k shortest pairs without materialising all N*(N-1)/2 edges.
+// A grid with cell size r finds every pair closer than r by scanning the 27
+// neighbouring cells. r starts at the radius that would hold about k pairs
+// if the points were uniform, and doubles until k pairs fit inside it.
+// Memory is O(N + k). Returned edges are sorted ascending.
+static Edge *knn_pairs_grid(Arena *arena, Vec3_s32 *points, u64 count, u64 k,
+                            u64 *out_count) {
+  u64 total_pairs = count > 1 ? count * (count - 1) / 2 : 0;
+  u64 want = Min(k, total_pairs);
+  Edge_Heap heap = {push_array_no_zero(arena, Edge, want), 0, want};
+  *out_count = 0;
+  if (want == 0)
+    return heap.v;
+
+  Vec3_s32 min = points[0], max = points[0];
+  for (u64 i = 1; i < count; i++) {
+    min.x = Min(min.x, points[i].x);
+    min.y = Min(min.y, points[i].y);
+    min.z = Min(min.z, points[i].z);
+    max.x = Max(max.x, points[i].x);
+    max.y = Max(max.y, points[i].y);
+    max.z = Max(max.z, points[i].z);
+  }
+
+  // Expected pairs within r for uniform density:
+  // N^2/2 * (4/3 pi r^3) / V = k  ->  r^3 = 3 k V / (2 pi N^2)
+  f64 volume = (f64)((s64)max.x - min.x + 1) * (f64)((s64)max.y - min.y + 1) *
+               (f64)((s64)max.z - min.z + 1);
+  f64 target = 3.0 * (f64)want * volume / (2.0 * pi_F64 * (f64)count *
+                                           (f64)count);
+  s64 lo = 1, hi = (s64)1 << 34;
+  while (lo < hi) {
+    s64 mid = lo + (hi - lo) / 2;
+    if ((f64)mid * (f64)mid * (f64)mid < target)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  s64 cell_size = lo;
+
+  for (;;) {
+    Scratch scratch = scratch_begin(&arena, 1);
+    Point_Grid grid =
+        point_grid_build(scratch.arena, points, count, min, cell_size);
+    u64 max_dist_sq = cell_size < ((s64)1 << 32)
+                          ? (u64)cell_size * (u64)cell_size
+                          : MAX_U64;
+    heap.count = 0;
+
+    for (u64 i = 0; i < count; i++) {
+      Vec3_s32 p = points[i];
+      s64 cx = ((s64)p.x - min.x) / cell_size;
+      s64 cy = ((s64)p.y - min.y) / cell_size;
+      s64 cz = ((s64)p.z - min.z) / cell_size;
+
+      for (s64 dz = -1; dz <= 1; dz++) {
+        for (s64 dy = -1; dy <= 1; dy++) {
+          for (s64 dx = -1; dx <= 1; dx++) {
+            u64 key = grid_key_from_cell(cx + dx, cy + dy, cz + dz);
+            u64 b = grid_bucket_from_key(&grid, key);
+            for (u32 s = grid.bucket_start[b]; s < grid.bucket_start[b + 1];
+                 s++) {
+              u32 j = grid.point_idx[s];
+              if (j <= i || grid.cell_key[j] != key)
+                continue;
+              s64 ddx = p.x - points[j].x;
+              s64 ddy = p.y - points[j].y;
+              s64 ddz = p.z - points[j].z;
+              u64 dist_sq = (u64)(ddx * ddx + ddy * ddy + ddz * ddz);
+              if (dist_sq <= max_dist_sq) {
+                edge_heap_push(&heap, (Edge){(u32)i, j, dist_sq});
+              }
+            }
+          }
+        }
+      }
+    }
+    scratch_end(scratch);
+
+    if (heap.count == want)
+      break;
+    cell_size *= 2;
+  }
+
+  edge_heap_sort(&heap);
+  *out_count = heap.count;
+  return heap.v;
+}
+
+static u64 solve_part1_grid(Arena *arena, Vec3_s32 *points, u64 point_count,
+                            u64 connections) {
+  Scratch scratch = scratch_begin(&arena, 1);
+  u64 edge_count = 0;
+  Edge *edges = knn_pairs_grid(scratch.arena, points, point_count,
+                               connections, &edge_count);
+
+  Union_Find uf = union_find_alloc(scratch.arena, point_count);
+  u32 *sizes = push_array(scratch.arena, u32, point_count);
+  for (u64 i = 0; i < edge_count; i++) {
+    union_find_union(&uf, edges[i].a, edges[i].b);
+  }
+  for (u64 i = 0; i < point_count; i++) {
+    sizes[union_find_find(&uf, (u32)i)]++;
+  }
+
+  u64 result = top3_size_product(sizes, point_count);
+  scratch_end(scratch);
+  return result;
+}
+
 static void thread_entry_point(void *p) {
   Thread_Params *params = (Thread_Params *)p;
   Lane_Ctx ctx = params->lane_ctx;
 
+  // Pin before anything is touched, so first-touch pages land on this CPU's
+  // node. The zero handle means the calling thread.
+  if (params->pin_cpu != MAX_U32) {
+    Thread self = {0};
+    os_thread_set_affinity(self, params->pin_cpu);
+  }
+
   TCTX *tctx = tctx_alloc();
   tctx_select(tctx);
   tctx_lane_init(ctx.lane_idx, ctx.lane_count, ctx.barrier,
-                 ctx.broadcast_memory);
+                 ctx.broadcast_memory, ctx.slots);
 
   Scratch scratch = scratch_begin(0, 0);
 
-  generate_edges_lane(params->points, params->point_count, params->edges,
-                      params->edge_idx_counter);
-  lane_sync();
-
   u64 start, elapsed;
   u64 result;
 
-  lane_sync();
-  start = os_now_microseconds();
-  radix_sort_u64_lane(params->edges, params->edge_count, sizeof(Edge),
-                      edge_get_key, params->edge_temp, params->lane_histograms,
-                      params->global_histogram);
-  result = solve_part1_lane(params->edges, params->edge_count,
-                            params->point_count, 1000, params->uf_parent,
-                            params->uf_rank, params->uf_sizes);
-  lane_sync();
-  elapsed = os_now_microseconds() - start;
-  if (lane_idx() == 0) {
-    *params->result_p1_slow = result;
-    *params->time_p1_slow = elapsed;
-  }
+  if (!params->sparse_only) {
+    lane_first_touch(params->edges, params->edge_count);
+    generate_edges_lane(params->points_soa, params->edges);
+    lane_sync();
+
+    lane_sync();
+    start = os_now_microseconds();
+    u64 topk_count = select_topk_edges_lane(
+        params->edges, params->edge_count, 1000, params->shared_arena,
+        params->topk_edges);
+    result = solve_part1_lane(params->topk_edges, topk_count,
+                              params->point_count, 1000, params->uf,
+                              params->uf_sizes);
+    lane_sync();
+    elapsed = os_now_microseconds() - start;
+    if (lane_idx() == 0) {
+      *params->result_p1_topk = result;
+      *params->time_p1_topk = elapsed;
+    }
 
-  lane_sync();
-  start = os_now_microseconds();
-  result = solve_part1_lane(params->edges, params->edge_count,
-                            params->point_count, 1000, params->uf_parent,
-                            params->uf_rank, params->uf_sizes);
-  lane_sync();
-  elapsed = os_now_microseconds() - start;
-  if (lane_idx() == 0) {
-    *params->result_p1_fast = result;
-    *params->time_p1_fast = elapsed;
+    lane_sync();
+    start = os_now_microseconds();
+    if (params->edge_temp) {
+      radix_sort_edge_lsd_lane(params->edges, params->edge_count,
+                               params->edge_temp, params->lane_histograms,
+                               params->global_histogram, params->radix_flags);
+    } else {
+      radix_sort_edge_in_place_lane(params->edges, params->edge_count,
+                                    params->lane_histograms,
+                                    params->global_histogram);
+    }
+    result = solve_part1_lane(params->edges, params->edge_count,
+                              params->point_count, 1000, params->uf,
+                              params->uf_sizes);
+    lane_sync();
+    elapsed = os_now_microseconds() - start;
+    if (lane_idx() == 0) {
+      *params->result_p1_slow = result;
+      *params->time_p1_slow = elapsed;
+    }
+
+    lane_sync();
+    start = os_now_microseconds();
+    result = solve_part1_lane(params->edges, params->edge_count,
+                              params->point_count, 1000, params->uf,
+                              params->uf_sizes);
+    lane_sync();
+    elapsed = os_now_microseconds() - start;
+    if (lane_idx() == 0) {
+      *params->result_p1_fast = result;
+      *params->time_p1_fast = elapsed;
+    }
+
+    lane_sync();
+    start = os_now_microseconds();
+    result = solve_part2_lane(params->points, params->edges,
+                              params->edge_count, params->point_count,
+                              params->uf, params->kruskal_keep);
+    lane_sync();
+    elapsed = os_now_microseconds() - start;
+    if (lane_idx() == 0) {
+      *params->result_p2 = result;
+      *params->time_p2 = elapsed;
+    }
   }
 
   lane_sync();
   start = os_now_microseconds();
-  result =
-      solve_part2_lane(params->points, params->edges, params->edge_count,
-                       params->point_count, params->uf_parent, params->uf_rank);
+  result = solve_part2_prim_lane(params->points_soa, params->prim_min_dist,
+                                 params->prim_min_from, params->prim_in_tree,
+                                 params->prim_candidates);
   lane_sync();
   elapsed = os_now_microseconds() - start;
   if (lane_idx() == 0) {
-    *params->result_p2 = result;
-    *params->time_p2 = elapsed;
+    *params->result_p2_prim = result;
+    *params->time_p2_prim = elapsed;
   }
 
   scratch_end(scratch);
@@ -273,10 +721,24 @@ static void thread_entry_point(void *p) {
 }
 
 void entry_point(Cmd_Line *cmd_line) {
-  Arena *arena = arena_alloc();
+  Arena *arena = arena_alloc(.flags = ArenaFlag_LargePages);
   log_init(arena, str_lit(""));
 
-  String input_path = str_lit("inputs/day_08.txt");
+  // -input=<path> runs a different point set, -sparse skips every engine
+  // that needs the O(N^2) edge list, -physical runs one lane per physical
+  // core, pinned, so no two lanes share a core's caches and load ports.
+  String input_path = cmd_line_string(cmd_line, str_lit("input"));
+  if (input_path.size == 0) {
+    input_path = str_lit("inputs/day_08.txt");
+  }
+  b32 sparse_only = cmd_line_has_flag(cmd_line, str_lit("sparse"));
+  b32 physical_only = cmd_line_has_flag(cmd_line, str_lit("physical"));
+  b32 lsd = cmd_line_has_flag(cmd_line, str_lit("lsd"));
+  RadixFlags radix_flags = 0;
+  if (cmd_line_has_flag(cmd_line, str_lit("write-combine"))) {
+    radix_flags |= RadixFlag_WriteCombine;
+  }
+
   String input = os_data_from_file_path(arena, input_path);
   if (input.size == 0) {
     print("Error: Could not read {S}\n", input_path);
@@ -291,53 +753,111 @@ void entry_point(Cmd_Line *cmd_line) {
 
   Vec3_s32 *points = push_array(arena, Vec3_s32, line_count);
   u64 point_count = parse_points(input, points, line_count);
-  u64 edge_count = (point_count * (point_count - 1)) / 2;
+  Vec3_s32_SoA points_soa =
+      vec3_s32_soa_from_array(arena, points, point_count);
 
-  Edge *edges = push_array(arena, Edge, edge_count);
-  void *edge_temp = push_array(arena, u8, edge_count * sizeof(Edge));
-  u64 edge_idx_counter = 0;
+  u64 grid_start = os_now_microseconds();
+  u64 result_p1_grid = solve_part1_grid(arena, points, point_count, 1000);
+  u64 time_p1_grid = os_now_microseconds() - grid_start;
 
-  u64 num_lanes = os_get_system_info()->logical_processors;
-  u64 *lane_histograms = push_array(arena, u64, num_lanes * 256);
-  u64 *global_histogram = push_array(arena, u64, 256);
+  OS_System_Info *system_info = os_get_system_info();
+  u64 num_lanes = system_info->logical_processors;
+  if (physical_only) {
+    num_lanes = system_info->physical_cores;
+  }
+
+  u64 edge_count = 0;
+  Arena *edge_arena = 0;
+  Edge *edges = 0;
+  Edge *edge_temp = 0;
+  Edge *topk_edges = 0;
+  u64 *lane_histograms = 0;
+  u64 *global_histogram = 0;
+  if (!sparse_only) {
+    edge_count = (point_count * (point_count - 1)) / 2;
+    // Not zeroed here: each lane first-touches its lane_range slice, which
+    // is the slice it generates and the one top-k scans, so on a NUMA box
+    // those passes stay on the lane's node. The sorts still move edges
+    // across slices. The edges get their own arena without LargePages:
+    // whoever faults a 2MB page first places all of it, and lane slices
+    // don't line up with 2MB pages.
+    u64 edge_bytes = edge_count * sizeof(Edge);
+    edge_arena = arena_alloc(.reserve_size = (lsd ? 2 : 1) * edge_bytes + MB(1));
+    edges = push_array_no_zero(edge_arena, Edge, edge_count);
+    if (lsd) {
+      edge_temp = push_array_no_zero(edge_arena, Edge, edge_count);
+    }
+    topk_edges = push_array(arena, Edge, 1000);
+    lane_histograms =
+        push_array(arena, u64, RADIX_LANE_HISTOGRAM_COUNT(num_lanes));
+    global_histogram = push_array(arena, u64, RADIX_GLOBAL_HISTOGRAM_COUNT);
+  }
 
-  u32 *uf_parent = push_array(arena, u32, point_count);
-  u32 *uf_rank = push_array(arena, u32, point_count);
+  Union_Find uf = union_find_alloc(arena, point_count);
   u32 *uf_sizes = push_array(arena, u32, point_count);
+  u8 *kruskal_keep = push_array(arena, u8, KRUSKAL_CHUNK_SIZE);
+
+  u64 *prim_min_dist = push_array(arena, u64, point_count);
+  u32 *prim_min_from = push_array(arena, u32, point_count);
+  u8 *prim_in_tree = push_array(arena, u8, point_count);
+  Prim_Candidate *prim_candidates =
+      push_array(arena, Prim_Candidate, 2 * num_lanes);
 
   Barrier barrier = barrier_alloc(num_lanes);
   u64 broadcast_val = 0;
+  Lane_Slot *lane_slots = tctx_lane_slots_alloc(arena, num_lanes);
+  Shared_Arena *shared_arena = shared_arena_alloc(.chunk_size = MB(1));
 
   Thread *threads = push_array(arena, Thread, num_lanes);
   Thread_Params *params = push_array(arena, Thread_Params, num_lanes);
 
-  u64 result_p1_slow = 0, result_p1_fast = 0, result_p2 = 0;
-  u64 time_p1_slow = 0, time_p1_fast = 0, time_p2 = 0;
+  u64 result_p1_topk = 0, result_p1_slow = 0, result_p1_fast = 0;
+  u64 result_p2 = 0, result_p2_prim = 0;
+  u64 time_p1_topk = 0, time_p1_slow = 0, time_p1_fast = 0, time_p2 = 0;
+  u64 time_p2_prim = 0;
 
   for (u64 i = 0; i < num_lanes; i++) {
     params[i].lane_ctx.lane_idx = i;
     params[i].lane_ctx.lane_count = num_lanes;
     params[i].lane_ctx.barrier = barrier;
     params[i].lane_ctx.broadcast_memory = &broadcast_val;
+    params[i].lane_ctx.slots = lane_slots;
     params[i].arena = arena;
     params[i].input = input;
     params[i].points = points;
     params[i].point_count = point_count;
+    params[i].points_soa = points_soa;
     params[i].edges = edges;
-    params[i].edge_count = edge_count;
-    params[i].edge_idx_counter = &edge_idx_counter;
     params[i].edge_temp = edge_temp;
+    params[i].radix_flags = radix_flags;
+    params[i].edge_count = edge_count;
+    params[i].topk_edges = topk_edges;
+    params[i].shared_arena = shared_arena;
     params[i].lane_histograms = lane_histograms;
     params[i].global_histogram = global_histogram;
-    params[i].uf_parent = uf_parent;
-    params[i].uf_rank = uf_rank;
+    params[i].uf = &uf;
     params[i].uf_sizes = uf_sizes;
+    params[i].kruskal_keep = kruskal_keep;
+    params[i].prim_min_dist = prim_min_dist;
+    params[i].prim_min_from = prim_min_from;
+    params[i].prim_in_tree = prim_in_tree;
+    params[i].prim_candidates = prim_candidates;
+    params[i].sparse_only = sparse_only;
+    params[i].pin_cpu = MAX_U32;
+    if (physical_only) {
+      params[i].pin_cpu =
+          system_info->cpu_order[i % system_info->logical_processors];
+    }
+    params[i].result_p1_topk = &result_p1_topk;
     params[i].result_p1_slow = &result_p1_slow;
     params[i].result_p1_fast = &result_p1_fast;
     params[i].result_p2 = &result_p2;
+    params[i].result_p2_prim = &result_p2_prim;
+    params[i].time_p1_topk = &time_p1_topk;
     params[i].time_p1_slow = &time_p1_slow;
     params[i].time_p1_fast = &time_p1_fast;
     params[i].time_p2 = &time_p2;
+    params[i].time_p2_prim = &time_p2_prim;
     threads[i] = thread_launch(thread_entry_point, &params[i]);
   }
 
@@ -350,20 +870,44 @@ void entry_point(Cmd_Line *cmd_line) {
   char buf[32];
   u32 len;
 
-  len = fmt_u64_to_str(result_p1_slow, buf, 10);
-  buf[len] = 0;
-  print("Part 1 (radix+lane): {s} (time: {u} us)\n", buf, (u32)time_p1_slow);
+  if (!sparse_only) {
+    len = fmt_u64_to_str(result_p1_topk, buf, 10);
+    buf[len] = 0;
+    print("Part 1 (topk+lane):  {s} (time: {u} us)\n", buf,
+          (u32)time_p1_topk);
+
+    len = fmt_u64_to_str(result_p1_slow, buf, 10);
+    buf[len] = 0;
+    print(lsd ? "Part 1 (lsd+lane):   {s} (time: {u} us)\n"
+              : "Part 1 (msd+lane):   {s} (time: {u} us)\n",
+          buf, (u32)time_p1_slow);
+
+    len = fmt_u64_to_str(result_p1_fast, buf, 10);
+    buf[len] = 0;
+    print("Part 1 (lane only):  {s} (time: {u} us)\n", buf,
+          (u32)time_p1_fast);
+  }
 
-  len = fmt_u64_to_str(result_p1_fast, buf, 10);
+  len = fmt_u64_to_str(result_p1_grid, buf, 10);
   buf[len] = 0;
-  print("Part 1 (lane only):  {s} (time: {u} us)\n", buf, (u32)time_p1_fast);
+  print("Part 1 (grid knn):   {s} (time: {u} us)\n", buf, (u32)time_p1_grid);
 
   print("\n");
 
-  len = fmt_u64_to_str(result_p2, buf, 10);
+  if (!sparse_only) {
+    len = fmt_u64_to_str(result_p2, buf, 10);
+    buf[len] = 0;
+    print("Part 2 (lane):       {s} (time: {u} us)\n", buf, (u32)time_p2);
+  }
+
+  len = fmt_u64_to_str(result_p2_prim, buf, 10);
   buf[len] = 0;
-  print("Part 2 (lane):       {s} (time: {u} us)\n", buf, (u32)time_p2);
+  print("Part 2 (prim+lane):  {s} (time: {u} us)\n", buf, (u32)time_p2_prim);
 
+  shared_arena_release(shared_arena);
+  if (edge_arena) {
+    arena_release(edge_arena);
+  }
   barrier_release(barrier);
   arena_release(arena);
 }